@@ -38,7 +38,7 @@ int main( int nArgs, char* arg[] ) {
                                     {-1,-1,0,-1}};
     Pochoir_3D lbm(lbm_shape);
     /* z ranges from -2 to SIZE_Z+2 */
-    Pochoir_Array_3D(PoCellEntry) pa(SIZE_Z+2*MARGIN_Z, SIZE_Y, SIZE_X);
+    LBM_Array_3D(PoCellEntry) pa(SIZE_Z+2*MARGIN_Z, SIZE_Y, SIZE_X);
     Pochoir_Domain X(0, SIZE_X), Y(0, SIZE_Y), Z(0+MARGIN_Z, SIZE_Z+MARGIN_Z);
     lbm.Register_Array(pa);
     lbm.Register_Domain(Z, Y, X);
@@ -175,7 +175,7 @@ void MAIN_printInfo( const MAIN_Param* param ) {
 
 /*############################################################################*/
 
-void MAIN_initialize( const MAIN_Param* param, Pochoir_Array_3D(PoCellEntry) & pa ) {
+void MAIN_initialize( const MAIN_Param* param, LBM_Array_3D(PoCellEntry) & pa ) {
 //  LBM_allocateGrid( (MY_TYPE**) &srcGrid );
 //  LBM_allocateGrid( (MY_TYPE**) &dstGrid );
 
@@ -204,7 +204,7 @@ void MAIN_initialize( const MAIN_Param* param, Pochoir_Array_3D(PoCellEntry) & p
 
 /*############################################################################*/
 
-void MAIN_finalize( const MAIN_Param* param, Pochoir_Array_3D(PoCellEntry) & pa, const int t ) {
+void MAIN_finalize( const MAIN_Param* param, LBM_Array_3D(PoCellEntry) & pa, const int t ) {
     printf("MAIN_finalize: srcGrid:\n");
     LBM_showGridStatistics( pa, t-1 );
     printf("MAIN_finalize: dstGrid:\n");
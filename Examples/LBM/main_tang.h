@@ -40,8 +40,8 @@ typedef struct {
 
 void MAIN_parseCommandLine( int nArgs, char* arg[], MAIN_Param* param );
 void MAIN_printInfo( const MAIN_Param* param );
-void MAIN_initialize( const MAIN_Param* param, Pochoir_Array_3D(PoCellEntry) & pa );
-void MAIN_finalize( const MAIN_Param* param, Pochoir_Array_3D(PoCellEntry) & pa, const int t );
+void MAIN_initialize( const MAIN_Param* param, LBM_Array_3D(PoCellEntry) & pa );
+void MAIN_finalize( const MAIN_Param* param, LBM_Array_3D(PoCellEntry) & pa, const int t );
 
 #if !defined(SPEC_CPU)
 void MAIN_startClock( MAIN_Time* time );
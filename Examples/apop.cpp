@@ -64,6 +64,8 @@ void print_usage( char *prog )
   printf( "\t-s value : steps in space dimension ( default: %d )\n", DEFAULT_s );
   printf( "\t-t value : steps in time dimension ( default: %d )\n\n", DEFAULT_t );
 
+  printf( "\t-n value : price an ensemble of n options at once, with exercise prices from 0.5 to 1.5 x E ( default: off )\n\n" );
+
   printf( "\t-i               : Run iterative stencil\n\n" );  
    
   printf( "\t-h               : print this help screen\n\n" );
@@ -74,7 +76,7 @@ void print_usage( char *prog )
 
 int read_command_line( int argc, char *argv[ ], 
 		       double &S, double &E, double &r, double &V, double &T, 
-		       int &ns, int &nt,
+		       int &ns, int &nt, int &ne,
                        int &Run_iter_stencil )
 {
   S = DEFAULT_S;
@@ -85,6 +87,7 @@ int read_command_line( int argc, char *argv[ ],
   
   ns = DEFAULT_s;
   nt = DEFAULT_t;
+  ne = 0;
   
   Run_iter_stencil = 0;
 
@@ -255,6 +258,28 @@ int read_command_line( int argc, char *argv[ ],
         if ( i >= argc ) break;
        }
 
+
+     if ( !strcmp( argv[ i ], "-n" ) )
+       {
+        if ( i + 1 >= argc )
+          {
+           printf( "Error: Missing number of options ( specify -n number-of-options )!\n\n" );
+           return 0;
+          }
+
+        ne = atoi( argv[ i + 1 ] );
+
+        if ( ne <= 0 )
+          {
+           printf( "Error: Number of options must be positive!\n\n" );
+           return 0;
+          }
+
+        i += 2;
+
+        if ( i >= argc ) break;
+       }
+
                      
      if ( !strcmp( argv[ i ], "-h" ) || !strcmp( argv[ i ], "-help" ) || !strcmp( argv[ i ], "--help" ) )
        {
@@ -282,6 +307,7 @@ int read_command_line( int argc, char *argv[ ],
   
    printf( "\t steps in space dimension = %d\n", ns );
    printf( "\t steps in time dimension = %d\n\n", nt );
+   if ( ne > 0 ) printf( "\t options in the ensemble = %d\n\n", ne );
     
    return 1;
 }
@@ -356,6 +382,70 @@ double stencilAPOP( double S, double E, double r, double V, double T,
 
 
 
+/* ne options at once, option e with exercise price E[ e ] : the option
+ * index is the first spatial index, of slope 0 
+ */
+Pochoir_Boundary_2D( apop_bv_2D, arr, t, e, i )
+
+   if ( ( i < arr.size( 0 ) - 1 ) || ( t == 0 ) ) return arr.get( t, e, i );
+   else return 0;
+
+Pochoir_Boundary_End
+
+
+
+void stencilEnsembleAPOP( double S, double * E, double r, double V, double T, 
+		          int ns, int nt, int ne, double * price )
+{
+   ns = ns + ( ns & 1 );
+   double dS = 2.0 * S / ns;
+   
+   Pochoir_Shape< N_RANK + 1 > APOP_ensemble_shape[ sizeof( APOP_shape ) / sizeof( APOP_shape[ 0 ] ) ];
+   Pochoir_Ensemble_Shape( APOP_shape, APOP_ensemble_shape );
+   Pochoir< N_RANK + 1 > APOP(APOP_ensemble_shape);
+   Pochoir_Array< double, N_RANK + 1 > c( ne, ns + 1 );
+   Pochoir_Array< double, N_RANK + 1 > f( ne, ns + 1 );
+   Pochoir_Array< double, N_RANK > c1( ns + 1 );
+   APOP.Register_Array( f );    
+   APOP.Register_Array( c );
+   c1.Register_Shape(APOP_shape);
+   
+   computeCoeffs( r, V, T, ns, nt, c1 );   
+   
+   cilk_for ( int e = 0; e < ne; ++e )
+     {
+       for ( int i = 0; i <= ns; ++i )
+         {
+           c.interior( 0, e, i ) = c1.interior( 0, i );
+           c.interior( 1, e, i ) = c1.interior( 1, i );
+           f.interior( 0, e, i ) = max( 0.0, E[ e ] - i * dS );
+         }
+       f.interior( 1, e, 0 ) = E[ e ];    
+     }
+       
+   Pochoir_Domain O( 0, ne ), I( 1, ns );
+    
+   Pochoir_Kernel_2D( APOP_fn, t, e, i )
+        
+       double v = c( 0, e, i ) * f( t, e, i - 1 )
+                + c( 1, e, i ) * f( t, e, i )
+       	        + c( 2, e, i ) * f( t, e, i + 1 );
+        
+       f( t + 1, e, i ) = max( v, E[ e ] - i * dS );			   
+  
+   Pochoir_Kernel_End
+
+   APOP.Register_Domain( O, I );   
+   f.Register_Boundary( apop_bv_2D );
+
+   APOP.Run( nt, APOP_fn );
+    
+   for ( int e = 0; e < ne; ++e )
+       price[ e ] = f.interior( nt, e, ( ns >> 1 ) );    
+}
+
+
+
 double iterativeStencilAPOP( double S, double E, double r, double V, double T, 
 		             int ns, int nt )
 {
@@ -399,11 +489,11 @@ int main( int argc, char *argv[ ] )
     printf( "\nStencil-based DP for the price of American put option ( Run with option -h for help ).\n\n" );
 
     double S, E, r, V, T; 
-    int ns, nt;
+    int ns, nt, ne;
     
     int RunIterativeStencil;
 
-    if ( !read_command_line( argc, argv, S, E, r, V, T, ns, nt, RunIterativeStencil ) )
+    if ( !read_command_line( argc, argv, S, E, r, V, T, ns, nt, ne, RunIterativeStencil ) )
       {
         print_usage( argv[ 0 ] );
         return 1;
@@ -411,6 +501,48 @@ int main( int argc, char *argv[ ] )
 
     struct timeval start, end;
 
+    if ( ne > 0 )
+      {
+        double * Es = new double[ ne ];
+        double * prices = new double[ ne ];
+        double maxdiff = 0;
+
+        for ( int e = 0; e < ne; ++e )
+            Es[ e ] = E * ( 0.5 + ( double ) e / ne );
+
+        printf( "Running pochoir-based DP on an ensemble of %d options...", ne );
+        fflush( stdout );
+
+        gettimeofday( &start, 0 );        
+        stencilEnsembleAPOP( S, Es, r, V, T, ns, nt, ne, prices );    
+        gettimeofday( &end, 0 );
+
+        double t0 = tdiff( &end, &start );
+
+        printf( "\n\nPochoir ensemble:\n" );
+        printf( "\t option price ( E = %0.2lf ) = %.2lf\n", Es[ ne / 2 ], prices[ ne / 2 ] );    
+        printf( "\t Running time = %.3lf sec\n\n", t0 );    
+
+        printf( "Running pochoir-based DP option by option..." );
+        fflush( stdout );
+
+        gettimeofday( &start, 0 );        
+        for ( int e = 0; e < ne; ++e )
+            maxdiff = max( maxdiff, fabs( stencilAPOP( S, Es[ e ], r, V, T, ns, nt ) - prices[ e ] ) );
+        gettimeofday( &end, 0 );
+
+        double t1 = tdiff( &end, &start );
+
+        printf( "\n\nPochoir option by option:\n" );
+        printf( "\t max difference to the ensemble = %g\n", maxdiff );    
+        if ( t0 > 0 ) printf( "\t Running time = %.3lf sec ( %.3lf x Pochoir ensemble )\n\n", t1, t1 / t0 );    
+        else printf( "\t Running time = %.3lf sec\n\n", t1 );    
+
+        delete [] Es;
+        delete [] prices;
+        return 0;
+      }
+
     printf( "Running pochoir-based DP..." );
     fflush( stdout );
            
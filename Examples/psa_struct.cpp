@@ -416,11 +416,15 @@ int stencilPSA4Arrays( int nX, char *X, int nY, char *Y, int goCost, int geCost,
 int stencilPSA( int nX, char *X, int nY, char *Y, int goCost, int geCost, int *mmCost )
 {
     Pochoir_Shape< N_RANK > pSeq_shape_G[ ] = { { 2, 0 }, { 1, 0 }, { 0, -1 }, { 1, -1 } };
-    Pochoir< N_RANK > pSeq(pSeq_shape_G); 
-    Pochoir_Array< int, N_RANK > vG( nY + 1 ), vD( nY + 1 ), vI( nY + 1 );
+    Pochoir< N_RANK, 3 > pSeq(pSeq_shape_G); 
+    Pochoir_Array< int, N_RANK, 3 > vG( nY + 1 ), vD( nY + 1 ), vI( nY + 1 );
+#if GROUP_STORAGE
+    pSeq.Register_Array_Group( vG, vD, vI );
+#else
     pSeq.registerArray( vG );
     pSeq.registerArray( vD );
     pSeq.registerArray( vI );            
+#endif
 
     vG( 0, 0 ) = vG( 1, 0 ) = 0;
     
@@ -464,8 +468,8 @@ Pochoir_Shape< N_RANK > pSeq_shape[ ] = { { 2, 0 }, { 1, 0 }, { 0, -1 }, { 1, -1
 int stencilPSAStruct( int nX, char *X, int nY, char *Y, int goCost, int geCost, int *mmCost )
 {
     Pochoir_Shape< N_RANK > pSeq_shape[ ] = { { 2, 0 }, { 1, 0 }, { 0, -1 }, { 1, -1 } };    
-    Pochoir< N_RANK > pSeq(pSeq_shape);    
-    Pochoir_Array< NODE, N_RANK > pArray( nY + 1 );    
+    Pochoir< N_RANK, 3 > pSeq(pSeq_shape);    
+    Pochoir_Array< NODE, N_RANK, 3 > pArray( nY + 1 );    
     pSeq.registerArray( pArray );
     
     pArray( 0, 0 ).vG = pArray( 1, 0 ).vG = 0;
@@ -302,13 +302,20 @@ void stencilRNAi0( int nX, char *X, int i_0,
                    P_ARRAY_R2_T3 &SMAX,                    
                    P_ARRAY_R2_T3 &SP )
 {
-    Pochoir< N_RANK > pRNA(pRNA_shape); 
+    Pochoir< N_RANK, 3 > pRNA(pRNA_shape); 
     Pochoir_Domain I( 0, nX + 1 ), K( 0, nX + 1 );
+#if GROUP_STORAGE
+    /* SL, SR, SM, SMAX and SP are read at the same ( t, i, k ), 
+     * so keep them side by side in one buffer 
+     */
+    pRNA.Register_Array_Group( SL, SR, SM, SMAX, SP );
+#else
     pRNA.registerArray( SL );
     pRNA.registerArray( SR );
     pRNA.registerArray( SM );
     pRNA.registerArray( SMAX );
     pRNA.registerArray( SP );
+#endif
     pRNA.registerDomain( I, K );    
 
     for ( int k_0 = 1; k_0 <= nX; ++k_0 )
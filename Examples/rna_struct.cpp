@@ -72,7 +72,7 @@ typedef struct
    int SL, SR, SMAX, SP;
 } NODE;
 
-typedef Pochoir_Array< NODE, N_RANK > pArrayR2T3;
+typedef Pochoir_Array< NODE, N_RANK, 3 > pArrayR2T3;
 
 //#define TEST_TYPEDEF
 
@@ -351,7 +351,7 @@ int read_command_line( int argc, char *argv[ ], int &nx, char **fnX, int &run_st
 void stencilRNAi0( int nX, INT *X, int i_0, 
                    P_ARRAY_R2_T3 &pArray )
 {
-    Pochoir< N_RANK > pRNA(pRNA_shape);    
+    Pochoir< N_RANK, 3 > pRNA(pRNA_shape);    
     pRNA.registerArray( pArray );
 
     cilk_for ( int k_0 = 1; k_0 <= nX; ++k_0 )
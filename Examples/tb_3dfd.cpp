@@ -326,12 +326,12 @@ void init_variables()
 	aref(1, x, y, z) = r;
 	vsqref(x, y, z) = 0.001f;
       }
-    N_CORES = max(2, __cilkrts_get_nworkers());
+    N_CORES = max(2, pochoir_get_nworkers());
     printf("N_CORES = %d\n", N_CORES);
 }
 
-template <typename T_Array>
-void init_pochoir_array(T_Array & arr) 
+template <typename T_Array, typename T_Const_Array>
+void init_pochoir_array(T_Array & arr, T_Const_Array & vel) 
 {
   int count = 0;
   Nxy = Nx * Ny;
@@ -363,7 +363,7 @@ void init_pochoir_array(T_Array & arr)
 	
 	arr(0, z, y, x) = r;
 	arr(1, z, y, x) = r;
-	vsqref(x, y, z) = 0.001f;
+	vel.set(z, y, x) = 0.001f;
   }
 }
 void print_summary(char *header, double interval) {
@@ -472,10 +472,13 @@ int main(int argc, char *argv[])
 
   Pochoir_Shape_3D fd_shape_3D[26] = {{1, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 1}, {0, 0, 0, -1}, {0, 0, 1, 0}, {0, 0, -1, 0}, {0, 1, 0, 0}, {0, -1, 0, 0}, {0, 0, 0, 2}, {0, 0, 0, -2}, {0, 0, 2, 0}, {0, 0, -2, 0}, {0, 2, 0, 0}, {0, -2, 0, 0}, {0, 0, 0, 3}, {0, 0, 0, -3}, {0, 0, 3, 0}, {0, 0, -3, 0}, {0, 3, 0, 0}, {0, -3, 0, 0}, {0, 0, 0, 4}, {0, 0, 0, -4}, {0, 0, 4, 0}, {0, 0, -4, 0}, {0, 4, 0, 0}, {0, -4, 0, 0}};
   Pochoir_Array_3D(float) pa(Nz, Ny, Nx);
+  /* the velocity model never changes, one plane is enough */
+  Pochoir_Const_Array<float, 3> pvsq(Nz, Ny, Nx);
   Pochoir_3D fd_3D(fd_shape_3D);
   Pochoir_Domain I(0+ds, Nx-ds), J(0+ds, Ny-ds), K(0+ds, Nz-ds);
 
   fd_3D.Register_Array(pa);
+  fd_3D.Register_Array(pvsq);
   fd_3D.Register_Domain(I, J, K);
 
   Pochoir_Kernel_3D(fd_3D_fn, t, i, j, k)
@@ -493,12 +496,12 @@ int main(int argc, char *argv[])
               + c4 * ((pa(t, i, j, k+4) + pa(t, i, j, k-4)) 
                     + (pa(t, i, j+4, k) + pa(t, i, j-4, k)) 
                     + (pa(t, i+4, j, k) + pa(t, i-4, j, k)));
-     pa(t+1, i, j, k) = 2 * pa(t, i, j, k) - pa(t+1, i, j, k) + vsq[i * Nxy + j * Nx + k] * div;
+     pa(t+1, i, j, k) = 2 * pa(t, i, j, k) - pa(t+1, i, j, k) + pvsq(i, j, k) * div;
   Pochoir_Kernel_End
 
   dotest();
 
-  init_pochoir_array(pa);
+  init_pochoir_array(pa, pvsq);
   gettimeofday(&start, 0);
   fd_3D.Run(T, fd_3D_fn);
   gettimeofday(&end, 0);
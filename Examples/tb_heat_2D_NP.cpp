@@ -68,7 +68,13 @@ int main(int argc, char * argv[])
     T_SIZE = StrToInt(argv[2]);
     printf("N_SIZE = %d, T_SIZE = %d\n", N_SIZE, T_SIZE);
     Pochoir_Shape_2D heat_shape_2D[] = {{1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, -1, -1}, {0, 0, -1}, {0, 0, 1}, {0, 0, 0}};
-	Pochoir_Array_2D(double) a(N_SIZE, N_SIZE), b(N_SIZE+2, N_SIZE+2);
+#if BOUNDARY_FN_TYPE
+    /* heat_bv_2D as the boundary type of 'a', inlined into the boundary clone */
+	Pochoir_Array<double, N_RANK, 2, heat_bv_2D_fn> a(N_SIZE, N_SIZE);
+#else
+	Pochoir_Array_2D(double) a(N_SIZE, N_SIZE);
+#endif
+	Pochoir_Array_2D(double) b(N_SIZE+2, N_SIZE+2);
     Pochoir_2D heat_2D(heat_shape_2D);
 
 	cout << "a(T+1, J, I) = 0.125 * (a(T, J+1, I) - 2.0 * a(T, J, I) + a(T, J-1, I)) + 0.125 * (a(T, J, I+1) - 2.0 * a(T, J, I) + a(T, J, I-1)) + a(T, J, I)" << endl;
@@ -76,7 +82,20 @@ int main(int argc, char * argv[])
 	   a(t+1, i, j) = 0.125 * (a(t, i+1, j) - 2.0 * a(t, i, j) + a(t, i-1, j)) + 0.125 * (a(t, i, j+1) - 2.0 * a(t, i, j) + a(t, i, j-1)) + a(t, i, j);
     Pochoir_Kernel_End
 
+#if BOUNDARY_FN_TYPE
+    a.Register_Boundary(heat_bv_2D_fn());
+#else
     a.Register_Boundary(heat_bv_2D);
+#endif
+#if USER_BUFFER
+    /* the application owns the field, with rows padded to a leading 
+     * dimension of its own, and 'a' works on it in place
+     */
+    T_index l_ld = N_SIZE + 8;
+    T_index l_stride[N_RANK] = {1, l_ld};
+    double * l_field = new double[2 * l_ld * N_SIZE];
+    a.adopt(l_field, l_stride, l_ld * N_SIZE);
+#endif
     heat_2D.Register_Array(a);
     b.Register_Shape(heat_shape_2D);
 
@@ -112,10 +131,20 @@ int main(int argc, char * argv[])
 	std::cout << "Naive Loop: consumed time :" << min_tdiff << "ms" << std::endl;
 
 	t = T_SIZE;
+#if USER_BUFFER
+    /* the final time plane, straight out of the application's field */
+    std::shared_ptr<double> l_final = a.release(t);
+	for (int i = 0; i < N_SIZE; ++i) {
+	for (int j = 0; j < N_SIZE; ++j) {
+		check_result(t, i, j, l_final.get()[i * l_ld + j], b.interior(t, i+1, j+1));
+	} } 
+    delete [] l_field;
+#else
 	for (int i = 0; i < N_SIZE; ++i) {
 	for (int j = 0; j < N_SIZE; ++j) {
 		check_result(t, i, j, a.interior(t, i, j), b.interior(t, i+1, j+1));
 	} } 
+#endif
 
 	return 0;
 }
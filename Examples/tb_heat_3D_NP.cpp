@@ -71,6 +71,11 @@ int main(int argc, char * argv[])
     Pochoir_3D heat_3D(heat_shape_3D);
 	Pochoir_Array_3D(double) a(N_SIZE, N_SIZE, N_SIZE), b(N_SIZE, N_SIZE, N_SIZE);
     Pochoir_Domain I(1, N_SIZE-1), J(1, N_SIZE-1), K(1, N_SIZE-1);
+    /* optional 3rd argument : back array 'a' by an mmap'd file */
+    if (argc > 3) {
+        printf("mmap file = %s\n", argv[3]);
+        a.set_mmap_file(argv[3]);
+    }
     heat_3D.Register_Array(a);
     b.Register_Shape(heat_shape_3D);
 
@@ -64,7 +64,7 @@ void check_result(int t, int i, int j, int k, int l, double a, double b)
             return 0;
         else
             return arr.get(t, i, j, k, l);
-    Pochoir_Boundary_end
+    Pochoir_Boundary_End
 
     template <typename Array>
     void print_array(Array const & a) {
@@ -93,7 +93,6 @@ int main(int argc, char * argv[])
     printf("N_SIZE = %d, T_SIZE = %d\n", N_SIZE, T_SIZE);
 	/* data structure of Pochoir - row major */
 	Pochoir_Array<double, N_RANK> a(N_SIZE, N_SIZE, N_SIZE, N_SIZE), b(N_SIZE, N_SIZE, N_SIZE, N_SIZE);
-    Pochoir<double, N_RANK> heat_4D;
     Pochoir_Domain I(1, N_SIZE-1), J(1, N_SIZE-1), K(1, N_SIZE-1), L(1, N_SIZE-1);
     Pochoir_Shape<4> heat_shape_4D[] = 
         {{0, 0, 0, 0, 0}, {-1, 0, 0, 0, 0},
@@ -101,6 +100,9 @@ int main(int argc, char * argv[])
         {-1, 0, 1, 0, 0}, {-1, 0, -1, 0, 0},
         {-1, 0, 0, 1, 0}, {-1, 0, 0, -1, 0}, 
         {-1, 0, 0, 0, 1}, {-1, 0, 0, 0, -1}};
+    Pochoir<N_RANK> heat_4D(heat_shape_4D);
+    heat_4D.Register_Array(a);
+    b.Register_Shape(heat_shape_4D);
 
 	for (int i = 0; i < N_SIZE; ++i) {
 	for (int j = 0; j < N_SIZE; ++j) {
@@ -124,7 +126,7 @@ int main(int argc, char * argv[])
         b(1, i, j, k, l) = 0;
 	} } } }
 
-    Pochoir_kernel_4D(heat_4D_fn, t, i, j, k, l)
+    Pochoir_Kernel_4D(heat_4D_fn, t, i, j, k, l)
 #if DEBUG
        a(t, i, j, k, l) = a(t-1, i-1, j-1, k-1, l-1) + 0.01; 
 #else
@@ -135,7 +137,7 @@ int main(int argc, char * argv[])
          + 0.125 * (a(t-1, i, j, k, l+1) - 2.0 * a(t-1, i, j, k, l) + a(t-1, i, j, k, l-1))
          + a(t-1, i, j, k, l);
 #endif
-    Pochoir_kernel_end
+    Pochoir_Kernel_End
 
     /* we have to bind arrayInUse and Shape together 
      * => One arrayInUse, one shape[] => One slope[]
@@ -143,15 +145,13 @@ int main(int argc, char * argv[])
      * the boundary region and when to call the user supplied boundary
      * value function
      */
-//    heat_4D.registerBoundaryFn(a, heat_bv_4D);
-    heat_4D.registerArray(a);
-    heat_4D.registerShape(heat_shape_4D);
-    heat_4D.registerDomain(I, J, K, L);
+    a.Register_Boundary(heat_bv_4D);
+    heat_4D.Register_Domain(I, J, K, L);
 
 #if 1
     for (int times = 0; times < TIMES; ++times) {
 	    gettimeofday(&start, 0);
-        heat_4D.run(T_SIZE, heat_4D_fn);
+        heat_4D.Run(T_SIZE, heat_4D_fn);
 	    gettimeofday(&end, 0);
         min_tdiff = min(min_tdiff, (1.0e3 * tdiff(&end, &start)));
     }
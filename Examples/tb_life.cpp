@@ -116,6 +116,8 @@ int main(int argc, char * argv[])
 
 	gettimeofday(&start, 0);
     for (int times = 0; times < TIMES; ++times) {
+        /* each time the same T_SIZE steps from 0 */
+        life_2D.Set_Time(0);
         life_2D.Run(T_SIZE, life_2D_fn);
     }
 	gettimeofday(&end, 0);
@@ -137,6 +139,8 @@ int main(int argc, char * argv[])
 
 	gettimeofday(&start, 0);
     for (int times = 0; times < TIMES; ++times) {
+        /* each time the same T_SIZE steps from 0 */
+        bt_life_2D.Set_Time(0);
         bt_life_2D.Run(T_SIZE, bt_life_2D_fn);
     }
 	gettimeofday(&end, 0);
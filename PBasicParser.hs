@@ -52,7 +52,7 @@ lexer = Token.makeTokenParser (javaStyle
                                   "<", "<=", "==", "!=", "+=", "-=", "*=", "&=", "|=", 
                                   "<<=", ">>=", "^=", "++", "--", "?", ":", "&", "|", "~",
                                   ">>", "<<", "%", "^"],
-               reservedNames = ["Pochoir_Array", "Pochoir", "Pochoir_Domain", 
+               reservedNames = ["Pochoir_Array", "Pochoir_SoA_Array", "Pochoir_Const_Array", "Pochoir", "Pochoir_Domain", 
                                 "Pochoir", 
                                 "Pochoir_kernel_1D", "Pochoir_kernel_2D", 
                                 "Pochoir_kernel_3D", "Pochoir_kernel_end",
@@ -203,7 +203,7 @@ ppStencil l_id l_state =
 -- get all iterators from Kernel
 transKernel :: PKernel -> PStencil -> PMode -> PKernel
 transKernel l_kernel l_stencil l_mode =
-       let l_exprStmts = kStmt l_kernel
+       let l_exprStmts = transStmts (kStmt l_kernel) $ transConstTime $ sArrayInUse l_stencil
            l_kernelParams = kParams l_kernel
            l_iters =
                    case l_mode of 
@@ -290,7 +290,9 @@ registerUndefinedBoundaryFn l_id l_boundaryParams l_stencil =
                            aDims = [],
                            aMaxShift = 0,
                            aToggle = 0,
-                           aRegBound = True}
+                           aRegBound = True,
+                           aSoA = False,
+                           aConst = False}
     in do -- updateState $ updatePArray [(l_arrayName, l_pArray)]
           -- updateState $ updateStencilArray l_id l_pArray
           -- updateState $ updateStencilBoundary l_id True
@@ -312,7 +314,9 @@ registerUndefinedArray l_id l_arrayName l_stencil =
                            aDims = [],
                            aMaxShift = 0,
                            aToggle = 0,
-                           aRegBound = False}
+                           aRegBound = False,
+                           aSoA = False,
+                           aConst = False}
     in  do -- updateState $ updatePArray [(l_arrayName, l_pArray)]
            -- updateState $ updateStencilArray l_id l_pArray 
            return (l_id ++ ".Register_Array (" ++ l_arrayName ++ 
@@ -321,7 +325,9 @@ registerUndefinedArray l_id l_arrayName l_stencil =
 registerArray :: String -> String -> PArray -> PStencil -> GenParser Char ParserState String
 registerArray l_id l_arrayName l_pArray l_stencil =
     -- assume all participating array has the same shape/toggle! Is that true?
-    let l_revArray = l_pArray { aToggle = sToggle l_stencil }
+    -- except for a Pochoir_Const_Array, which has a single plane
+    let l_revArray = if aConst l_pArray then l_pArray
+                        else l_pArray { aToggle = sToggle l_stencil }
     in  do updateState $ updateStencilArray l_id l_revArray
            return (l_id ++ ".Register_Array (" ++ l_arrayName ++ 
                    "); /* register Array */" ++ breakline)
@@ -334,6 +340,43 @@ pDeclStatic = do l_type <- pType
                  l_rank <- exprDeclDim
                  return (l_type, l_rank)
 
+-- pDeclStaticToggle <type, rank[, toggle]>, toggle is 2 by default
+pDeclStaticToggle :: GenParser Char ParserState (PType, PValue, PValue)
+pDeclStaticToggle = do (l_type, l_rank) <- pDeclStatic
+                       l_toggle <- option 2 (comma >> exprDeclDim)
+                       return (l_type, l_rank, l_toggle)
+
+-- pDeclStaticToggleBF <type, rank[, toggle[, boundary[, layout]]]>, the 
+-- boundary function type and the layout don't matter to the code generation,
+-- so we return them as the text to append to the template arguments
+pDeclStaticToggleBF :: GenParser Char ParserState (PType, PValue, PValue, String)
+pDeclStaticToggleBF = do (l_type, l_rank, l_toggle) <- pDeclStaticToggle
+                         l_rest <- many (comma >> pTemplateArg)
+                         return (l_type, l_rank, l_toggle, concatMap (", " ++) l_rest)
+
+-- the text of one template argument, e.g. a boundary function type : a name,
+-- ns::bv, decltype(f) or a nested template. It runs up to the next ',' or 
+-- the closing '>' which are not inside a '<...>' or a '(...)'
+pTemplateArg :: GenParser Char ParserState String
+pTemplateArg = do l_arg <- many1 (pInAngles <|> pInParens <|> pChar "<>(),")
+                  return (reverse $ dropWhile isSpace $ reverse $ concat l_arg)
+    where pInAngles = do char '<'
+                         l_in <- many (pInAngles <|> pInParens <|> pChar "<>()")
+                         char '>'
+                         return ("<" ++ concat l_in ++ ">")
+          pInParens = do char '('
+                         l_in <- many (pInParens <|> pChar "()")
+                         char ')'
+                         return ("(" ++ concat l_in ++ ")")
+          pChar l_stop = do l_c <- noneOf l_stop
+                            return [l_c]
+
+-- pDeclStaticRankToggle <rank[, toggle]>, toggle is 2 by default
+pDeclStaticRankToggle :: GenParser Char ParserState (PValue, PValue)
+pDeclStaticRankToggle = do l_rank <- exprDeclDim
+                           l_toggle <- option 2 (comma >> exprDeclDim)
+                           return (l_rank, l_toggle)
+
 pDeclStaticNum :: GenParser Char ParserState (PValue)
 pDeclStaticNum = do l_rank <- exprDeclDim
                     return (l_rank)
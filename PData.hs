@@ -63,7 +63,11 @@ data PArray = PArray {
     aMaxShift :: Int,
     aToggle :: Int,
     aDims :: [DimExpr],
-    aRegBound :: Bool
+    aRegBound :: Bool,
+    -- aSoA : declared as Pochoir_SoA_Array, one plane per struct field
+    aSoA :: Bool,
+    -- aConst : declared as Pochoir_Const_Array, one plane without time index
+    aConst :: Bool
 } deriving (Show, Eq)
 data PStencil = PStencil {
     sName :: PName,
@@ -79,10 +79,13 @@ ppopp (mode, debug, showFile, userArgs) ((inFile, inDir):files) =
        let envPath = ["-I" ++ cilkStubPath] ++ ["-I" ++ pochoirLibPath]
 -}
        let envPath = ["-I" ++ pochoirLibPath]
+       -- user's -D flags (e.g. -DLONG_INDEX=0) have to be seen by the 
+       -- preprocessing pass, since that's where pochoir headers get expanded
+       let userDefs = filter (isPrefixOf "-D") userArgs
        let iccPPFile = inDir ++ getPPFile inFile
        let iccPPArgs = if debug == False
-             then iccPPFlags ++ envPath ++ [inFile]
-             else iccDebugPPFlags ++ envPath ++ [inFile] 
+             then iccPPFlags ++ userDefs ++ envPath ++ [inFile]
+             else iccDebugPPFlags ++ userDefs ++ envPath ++ [inFile] 
        -- a pass of icc preprocessing
        putStrLn (icc ++ " " ++ intercalate " " iccPPArgs)
        rawSystem icc iccPPArgs
@@ -53,6 +53,10 @@ pToken =
     <|> try pParseMacro
     <|> try pParsePochoirArray
     <|> try pParsePochoirArrayAsParam
+    <|> try pParsePochoirSoAArray
+    <|> try pParsePochoirSoAArrayAsParam
+    <|> try pParsePochoirConstArray
+    <|> try pParsePochoirConstArrayAsParam
     <|> try pParsePochoirStencil
     <|> try pParsePochoirStencilWithShape
     <|> try pParsePochoirStencilAsParam
@@ -78,29 +82,74 @@ pParseMacro =
 pParsePochoirArray :: GenParser Char ParserState String
 pParsePochoirArray =
     do reserved "Pochoir_Array"
-       (l_type, l_rank) <- angles $ try pDeclStatic
+       (l_type, l_rank, l_toggle, l_bf) <- angles $ try pDeclStaticToggleBF
        l_arrayDecl <- commaSep1 pDeclDynamic
        l_delim <- pDelim 
-       updateState $ updatePArray $ transPArray (l_type, l_rank) l_arrayDecl
+       updateState $ updatePArray $ transPArray (l_type, l_rank, l_toggle) l_arrayDecl
        return (breakline ++ "/* Known*/ Pochoir_Array <" ++ show l_type ++ 
-               ", " ++ show l_rank ++ "> " ++ 
+               ", " ++ show l_rank ++ ", " ++ show l_toggle ++ l_bf ++ "> " ++ 
                pShowDynamicDecl l_arrayDecl pShowArrayDim ++ l_delim)
 
 pParsePochoirArrayAsParam :: GenParser Char ParserState String
 pParsePochoirArrayAsParam =
     do reserved "Pochoir_Array"
-       (l_type, l_rank) <- angles $ try pDeclStatic
+       (l_type, l_rank, l_toggle, l_bf) <- angles $ try pDeclStaticToggleBF
        l_arrayDecl <- pDeclDynamic
        l_delim <- pDelim 
-       updateState $ updatePArray $ transPArray (l_type, l_rank) [l_arrayDecl]
+       updateState $ updatePArray $ transPArray (l_type, l_rank, l_toggle) [l_arrayDecl]
        return (breakline ++ "/* Known*/ Pochoir_Array <" ++ show l_type ++ 
+               ", " ++ show l_rank ++ ", " ++ show l_toggle ++ l_bf ++ "> " ++ 
+               pShowDynamicDecl [l_arrayDecl] pShowArrayDim ++ l_delim)
+
+pParsePochoirSoAArray :: GenParser Char ParserState String
+pParsePochoirSoAArray =
+    do reserved "Pochoir_SoA_Array"
+       (l_type, l_rank, l_toggle) <- angles $ try pDeclStaticToggle
+       l_arrayDecl <- commaSep1 pDeclDynamic
+       l_delim <- pDelim 
+       updateState $ updatePArray $ transSoAPArray $ transPArray (l_type, l_rank, l_toggle) l_arrayDecl
+       return (breakline ++ "/* Known*/ Pochoir_SoA_Array <" ++ show l_type ++ 
+               ", " ++ show l_rank ++ ", " ++ show l_toggle ++ "> " ++ 
+               pShowDynamicDecl l_arrayDecl pShowArrayDim ++ l_delim)
+
+pParsePochoirSoAArrayAsParam :: GenParser Char ParserState String
+pParsePochoirSoAArrayAsParam =
+    do reserved "Pochoir_SoA_Array"
+       (l_type, l_rank, l_toggle) <- angles $ try pDeclStaticToggle
+       l_arrayDecl <- pDeclDynamic
+       l_delim <- pDelim 
+       updateState $ updatePArray $ transSoAPArray $ transPArray (l_type, l_rank, l_toggle) [l_arrayDecl]
+       return (breakline ++ "/* Known*/ Pochoir_SoA_Array <" ++ show l_type ++ 
+               ", " ++ show l_rank ++ ", " ++ show l_toggle ++ "> " ++ 
+               pShowDynamicDecl [l_arrayDecl] pShowArrayDim ++ l_delim)
+
+-- a Pochoir_Const_Array <type, rank> has no toggle, it is a single plane
+pParsePochoirConstArray :: GenParser Char ParserState String
+pParsePochoirConstArray =
+    do reserved "Pochoir_Const_Array"
+       (l_type, l_rank) <- angles $ try pDeclStatic
+       l_arrayDecl <- commaSep1 pDeclDynamic
+       l_delim <- pDelim 
+       updateState $ updatePArray $ transConstPArray $ transPArray (l_type, l_rank, 1) l_arrayDecl
+       return (breakline ++ "/* Known*/ Pochoir_Const_Array <" ++ show l_type ++ 
+               ", " ++ show l_rank ++ "> " ++ 
+               pShowDynamicDecl l_arrayDecl pShowArrayDim ++ l_delim)
+
+pParsePochoirConstArrayAsParam :: GenParser Char ParserState String
+pParsePochoirConstArrayAsParam =
+    do reserved "Pochoir_Const_Array"
+       (l_type, l_rank) <- angles $ try pDeclStatic
+       l_arrayDecl <- pDeclDynamic
+       l_delim <- pDelim 
+       updateState $ updatePArray $ transConstPArray $ transPArray (l_type, l_rank, 1) [l_arrayDecl]
+       return (breakline ++ "/* Known*/ Pochoir_Const_Array <" ++ show l_type ++ 
                ", " ++ show l_rank ++ "> " ++ 
                pShowDynamicDecl [l_arrayDecl] pShowArrayDim ++ l_delim)
 
 pParsePochoirStencil :: GenParser Char ParserState String
 pParsePochoirStencil = 
     do reserved "Pochoir"
-       l_rank <- angles exprDeclDim
+       (l_rank, l_declToggle) <- angles pDeclStaticRankToggle
        l_rawStencils <- commaSep1 pDeclPochoir
        l_delim <- pDelim
        l_state <- getState
@@ -110,13 +159,13 @@ pParsePochoirStencil =
        let l_toggles = map shapeToggle l_pShapes
        updateState $ updatePStencil $ transPStencil l_rank l_stencils l_pShapes
        return (breakline ++ "/* Known */ Pochoir <" ++ show l_rank ++ 
-               "> " ++ pShowDynamicDecl l_rawStencils (showString "") ++ l_delim ++ 
+               ", " ++ show l_declToggle ++ "> " ++ pShowDynamicDecl l_rawStencils (showString "") ++ l_delim ++ 
                "/* toggles = " ++ show l_toggles ++ "*/")
 
 pParsePochoirStencilWithShape :: GenParser Char ParserState String
 pParsePochoirStencilWithShape = 
     do reserved "Pochoir"
-       l_rank <- angles exprDeclDim
+       (l_rank, l_declToggle) <- angles pDeclStaticRankToggle
        l_rawStencils <- commaSep1 pDeclPochoirWithShape
        l_delim <- pDelim
        l_state <- getState
@@ -125,13 +174,13 @@ pParsePochoirStencilWithShape =
        let l_toggles = map shapeToggle l_pShapes
        updateState $ updatePStencil $ transPStencil l_rank l_stencils l_pShapes
        return (breakline ++ "/* Known */ Pochoir <" ++ show l_rank ++ 
-               "> " ++ pShowDynamicDecl l_rawStencils (pShowShapes . shape) ++ l_delim ++ 
+               ", " ++ show l_declToggle ++ "> " ++ pShowDynamicDecl l_rawStencils (pShowShapes . shape) ++ l_delim ++ 
                "/* toggles = " ++ (show $ map shapeToggle l_pShapes) ++ "*/")
 
 pParsePochoirStencilAsParam :: GenParser Char ParserState String
 pParsePochoirStencilAsParam = 
     do reserved "Pochoir"
-       l_rank <- angles exprDeclDim
+       (l_rank, l_declToggle) <- angles pDeclStaticRankToggle
        l_rawStencil <- pDeclPochoir
        l_delim <- pDelim
        l_state <- getState
@@ -141,13 +190,13 @@ pParsePochoirStencilAsParam =
        let l_toggle = shapeToggle l_pShape
        updateState $ updatePStencil $ transPStencil l_rank [l_stencil] [l_pShape]
        return (breakline ++ "/* Known */ Pochoir <" ++ show l_rank ++ 
-               "> " ++ pShowDynamicDecl [l_rawStencil] (showString "") ++ l_delim ++ 
+               ", " ++ show l_declToggle ++ "> " ++ pShowDynamicDecl [l_rawStencil] (showString "") ++ l_delim ++ 
                "/* toggles = " ++ show l_toggle ++ "*/")
 
 pParsePochoirStencilWithShapeAsParam :: GenParser Char ParserState String
 pParsePochoirStencilWithShapeAsParam = 
     do reserved "Pochoir"
-       l_rank <- angles exprDeclDim
+       (l_rank, l_declToggle) <- angles pDeclStaticRankToggle
        l_rawStencil <- pDeclPochoirWithShape
        l_delim <- pDelim
        l_state <- getState
@@ -156,7 +205,7 @@ pParsePochoirStencilWithShapeAsParam =
        let l_toggle = shapeToggle l_pShape
        updateState $ updatePStencil $ transPStencil l_rank [l_stencil] [l_pShape]
        return (breakline ++ "/* Known */ Pochoir <" ++ show l_rank ++ 
-               "> " ++ pShowDynamicDecl [l_rawStencil] (pShowShapes . shape) ++ 
+               ", " ++ show l_declToggle ++ "> " ++ pShowDynamicDecl [l_rawStencil] (pShowShapes . shape) ++ 
                l_delim ++ "/* toggles = " ++ (show $ shapeToggle l_pShape) ++ "*/")
 
 pParsePochoirShapeInfo :: GenParser Char ParserState String
@@ -264,12 +313,18 @@ pMacroValue l_name =
                  return ("#define " ++ l_name ++ " " ++ l_value ++ "\n")
           <?> "Macro Definition"
 
-transPArray :: (PType, Int) -> [([PName], PName, [DimExpr])] -> [(PName, PArray)]
-transPArray (l_type, l_rank) [] = []
-transPArray (l_type, l_rank) (p:ps) =
+transPArray :: (PType, Int, Int) -> [([PName], PName, [DimExpr])] -> [(PName, PArray)]
+transPArray (l_type, l_rank, l_toggle) [] = []
+transPArray (l_type, l_rank, l_toggle) (p:ps) =
     let l_name = pSecond p
         l_dims = pThird p
-    in  (l_name, PArray {aName = l_name, aType = l_type, aRank = l_rank, aDims = l_dims, aMaxShift = 0, aToggle = 0, aRegBound = False}) : transPArray (l_type, l_rank) ps
+    in  (l_name, PArray {aName = l_name, aType = l_type, aRank = l_rank, aDims = l_dims, aMaxShift = 0, aToggle = l_toggle, aRegBound = False, aSoA = False, aConst = False}) : transPArray (l_type, l_rank, l_toggle) ps
+
+transSoAPArray :: [(PName, PArray)] -> [(PName, PArray)]
+transSoAPArray = map (\(l_name, l_array) -> (l_name, l_array { aSoA = True }))
+
+transConstPArray :: [(PName, PArray)] -> [(PName, PArray)]
+transConstPArray = map (\(l_name, l_array) -> (l_name, l_array { aConst = True }))
 
 transPStencil :: Int -> [PName] -> [PShape] -> [(PName, PStencil)]
 transPStencil l_rank [] _ = []
@@ -55,7 +55,7 @@ simplifyDimExprItem (DimDuo bop e1 e2)
     | otherwise = DimDuo bop (simplifyDimExprItem e1) (simplifyDimExprItem e2)
 simplifyDimExprItem (DimParen e) = DimParen (simplifyDimExprItem e)
 
-getFromStmts :: (PArray -> Expr -> [Iter]) -> Map.Map PName PArray -> [Stmt] -> [Iter]
+getFromStmts :: Eq a => (PArray -> Expr -> [a]) -> Map.Map PName PArray -> [Stmt] -> [a]
 getFromStmts l_action _ [] = []
 getFromStmts l_action l_arrayMap l_stmts@(a:as) = 
     let i1 = getFromStmt a 
@@ -100,6 +100,12 @@ getFromStmts l_action l_arrayMap l_stmts@(a:as) =
                    Just arrayInUse -> l_action arrayInUse (PVAR q v dL)
           getFromExpr (BVAR v dim) = []
           getFromExpr (BExprVAR v e) = getFromExpr e
+          -- l_action sees both the field access and the array access itself
+          getFromExpr (SVAR t (PVAR q v dL) c f) = 
+              case Map.lookup v l_arrayMap of
+                   Nothing -> []
+                   Just arrayInUse -> union (l_action arrayInUse (SVAR t (PVAR q v dL) c f))
+                                            (l_action arrayInUse (PVAR q v dL))
           getFromExpr (SVAR t e c f) = getFromExpr e
           getFromExpr (PSVAR t e c f) = getFromExpr e
           getFromExpr (Uno uop e) = getFromExpr e
@@ -141,7 +147,11 @@ transStmts l_stmts@(a:as) l_action = transStmt a : transStmts as l_action
           transExpr (PVAR q v dL) = l_action (PVAR q v dL)
           transExpr (BVAR v dim) = BVAR v dim
           transExpr (BExprVAR v e) = BExprVAR v $ transExpr e
-          transExpr (SVAR t e c f) = SVAR t (transExpr e) c f
+          -- l_action may rewrite a field access as a whole, 
+          -- otherwise we go down to the array access
+          transExpr (SVAR t e c f) = 
+              let e' = l_action (SVAR t e c f)
+              in  if e' == SVAR t e c f then SVAR t (transExpr e) c f else e'
           transExpr (PSVAR t e c f) = PSVAR t (transExpr e) c f
           transExpr (Uno uop e) = Uno uop $ transExpr e
           transExpr (PostUno uop e) = PostUno uop $ transExpr e
@@ -179,8 +189,16 @@ pDefMacroArrayInUse l_macro (a:as) pL = pDefMacroShadowItem l_macro a pL ++ pDef
     where pDefMacroShadowItem l_macro a pL = 
             let l_arrayName = aName a
                 l_arrayMacroName = l_arrayName ++ l_macro
-            in  "#define " ++ pShowArrayTerm l_arrayName pL ++ " " ++
-                pShowArrayTerm l_arrayMacroName pL ++ breakline
+                pL' = pArrayParams a pL
+            in  "#define " ++ pShowArrayTerm l_arrayName pL' ++ " " ++
+                pShowArrayTerm l_arrayMacroName pL' ++ breakline
+
+-- the indices of array a out of the kernel parameters, a Pochoir_Const_Array
+-- has no time index
+pArrayParams :: PArray -> [PName] -> [PName]
+pArrayParams a pL 
+    | aConst a = tail pL
+    | otherwise = pL
 
 pShowArrayTerm :: PName -> [PName] -> String
 pShowArrayTerm a pL = a ++ "(" ++ pShowListIdentifiers pL ++ ")"
@@ -190,7 +208,7 @@ pUndefMacroArrayInUse [] _ = ""
 pUndefMacroArrayInUse (a:as) pL = pUndefMacroShadowItem a pL ++ pUndefMacroArrayInUse as pL
     where pUndefMacroShadowItem a pL = 
             let l_arrayName = aName a
-            in  "#undef " ++ pShowArrayTerm l_arrayName pL ++ breakline
+            in  "#undef " ++ pShowArrayTerm l_arrayName (pArrayParams a pL) ++ breakline
 
 pShowKernel :: String -> PKernel -> String
 pShowKernel l_name l_kernel = "Pochoir_Kernel_" ++ show dim ++ "D(" ++ l_name ++ ", " ++
@@ -212,7 +230,7 @@ pShowKernelParams l_kernel_params = intercalate ", " l_kernel_params
 
 pShowArrayGaps :: Int -> [PArray] -> String
 pShowArrayGaps _ [] = ""
-pShowArrayGaps l_rank l_array = breakline ++ "int " ++ 
+pShowArrayGaps l_rank l_array = breakline ++ "T_index " ++ 
         intercalate ", " (map (getArrayGaps (l_rank-1)) l_array) ++ ";"
 
 pShowInteriorKernel :: String -> PKernel -> String
@@ -271,7 +289,8 @@ pShowPointerKernel l_name l_kernel =
         "int t0, int t1, grid_info<" ++ show l_rank ++ "> const & grid) {" ++ 
         breakline ++ "grid_info<" ++ show l_rank ++ "> l_grid = grid;" ++
         pShowPointers l_iter ++ breakline ++ 
-        pShowArrayInfo l_array ++ pShowArrayGaps l_rank l_array ++
+        pShowArrayInfo l_array ++ pShowSoAFields (getSoAFields l_kernel) ++
+        pShowArrayGaps l_rank l_array ++
         breakline ++ pShowStrides l_rank l_array ++ breakline ++
         "for (int " ++ l_t ++ " = t0; " ++ l_t ++ " < t1; ++" ++ l_t ++ ") { " ++ 
         pShowPointerSet l_iter (kParams l_kernel)++
@@ -279,21 +298,30 @@ pShowPointerKernel l_name l_kernel =
         breakline ++ pShowPointerStmt l_kernel ++ breakline ++ pShowObaseForTail l_rank ++
         pShowObaseTail l_rank ++ breakline ++ "};\n"
 
+-- the outer dimensions go through the per-dimension offset tables of the
+-- array layout (Pochoir_Array::layout_offset()), once per row, so the same 
+-- code runs on row-major, bricked and Morton-ordered arrays. The rows are 
+-- walked with the stride of dimension 0, which is 1 unless the array is 
+-- interleaved with others (Pochoir::Register_Array_Group).
 pShowOptPointerKernel :: String -> PKernel -> String
 pShowOptPointerKernel l_name l_kernel = 
     let l_rank = length (kParams l_kernel) - 1
         l_iter = kIter l_kernel
         l_array = unionArrayIter l_iter
         l_t = head $ kParams l_kernel
+        l_inner = last $ kParams l_kernel
     in  breakline ++ "auto " ++ l_name ++ " = [&] (" ++
         "int t0, int t1, grid_info<" ++ show l_rank ++ "> const & grid) {" ++ 
         breakline ++ "grid_info<" ++ show l_rank ++ "> l_grid = grid;" ++
         pShowPointers l_iter ++ breakline ++ 
-        pShowArrayInfo l_array ++ pShowArrayGaps l_rank l_array ++
-        breakline ++ pShowStrides l_rank l_array ++ breakline ++
+        pShowArrayInfo l_array ++ pShowSoAFields (getSoAFields l_kernel) ++
+        breakline ++ pShowStrides 1 l_array ++ pShowLayoutOffsets l_rank l_array ++ breakline ++
         "for (int " ++ l_t ++ " = t0; " ++ l_t ++ " < t1; ++" ++ l_t ++ ") { " ++ 
-        pShowOptPointerSet l_iter (kParams l_kernel)++
-        breakline ++ pShowPointerForHeader l_rank l_iter (tail $ kParams l_kernel) ++
+        pShowOuterForHeader l_rank (init $ tail $ kParams l_kernel) ++
+        pShowLayoutPointerSet l_iter (kParams l_kernel) ++ pShowPragma ++
+        breakline ++ "for (int " ++ l_inner ++ " = l_grid.x0[0]; " ++ l_inner ++ 
+        " < l_grid.x1[0]; ++" ++ l_inner ++ pShowIterComma l_iter ++ 
+        (intercalate ", " $ map pShowIterInc l_iter) ++ ") {" ++
         breakline ++ pShowOptPointerStmt l_kernel ++ breakline ++ pShowObaseForTail l_rank ++
         pShowObaseTail l_rank ++ breakline ++ "};\n"
 
@@ -308,17 +336,17 @@ pShowCPointerKernel l_name l_kernel =
         breakline ++ "grid_info<" ++ show l_rank ++ "> l_grid = grid;" ++
         pShowArrayInfo l_array ++ 
         breakline ++ pShowStrides l_rank l_array ++ breakline ++
-        pShowRefMacro (kParams l_kernel) l_array ++
+        pShowRefMacro (kParams l_kernel) (filter (not . aSoA) l_array) ++
         "for (int " ++ l_t ++ " = t0; " ++ l_t ++ " < t1; ++" ++ l_t ++ ") { " ++ 
         breakline ++ pShowRawForHeader (tail $ kParams l_kernel) ++
         breakline ++ pShowCPointerStmt l_kernel ++ breakline ++ pShowObaseForTail l_rank ++
-        pShowObaseTail l_rank ++ breakline ++ pShowRefUnMacro l_array ++ 
+        pShowObaseTail l_rank ++ breakline ++ pShowRefUnMacro (filter (not . aSoA) l_array) ++ 
         "};\n"
 
 pShowCPointerStmt :: PKernel -> String
 pShowCPointerStmt l_kernel = 
-    let oldStmts = kStmt l_kernel
-        l_iter = kIter l_kernel
+    let l_iter = kIter l_kernel
+        oldStmts = pConstTimeStmts l_iter $ kStmt l_kernel
         obaseStmts = transStmts oldStmts $ transCPointer l_iter
     in show obaseStmts
 
@@ -326,6 +354,8 @@ transCPointer :: [Iter] -> Expr -> Expr
 transCPointer l_iters (PVAR q v dL) =
     case pIterLookup (v, dL) l_iters of
         Nothing -> PVAR q v dL
+        -- no ref_ macro for Pochoir_SoA_Array, it goes through the proxy
+        Just iterName | isSoAArray v l_iters -> PVAR q v dL
         Just iterName -> VAR q $ pRef v dL
 transCPointer l_iters e = e
 
@@ -344,6 +374,14 @@ pShowRawForHeader pL@(p:ps) =
         "]; " ++ idx ++ " < l_grid.x1[" ++ show l_rank ++ "]; ++" ++ idx ++ ") {" ++
         pShowRawForHeader ps 
  
+-- for headers of the dimensions l_rank-1 .. 1, the innermost one is
+-- generated by the caller
+pShowOuterForHeader :: Int -> [PName] -> String
+pShowOuterForHeader l_rank pL = concat $ zipWith pShowOuterFor [l_rank-1, l_rank-2 .. 1] pL
+    where pShowOuterFor r idx = 
+            breakline ++ "for (int " ++ idx ++ " = l_grid.x0[" ++ show r ++
+            "]; " ++ idx ++ " < l_grid.x1[" ++ show r ++ "]; ++" ++ idx ++ ") {"
+
 pShowPragma :: String
 pShowPragma = breakline ++ "#pragma ivdep"
 -- pShowPragma = "#pragma ivdep" ++ breakline ++ "#pragma simd"
@@ -360,12 +398,11 @@ pShowRefMacro l_kernelParams aL@(a:as) =
     let l_name = aName a
         l_t = head l_kernelParams
         l_dims = tail l_kernelParams
-        l_toggle = aToggle a
         l_rank = aRank a
     in  "#define ref_" ++ l_name ++ "(" ++ pShowKernelParams l_kernelParams ++
-        ") " ++ l_name ++ "_base[" ++ pGetTimeOffset l_toggle (DimVAR l_t) ++
-        " * l_" ++ l_name ++ "_total_size + " ++ 
-        (intercalate " + " $ zipWith pMul l_dims $ pStrideList l_name l_rank) ++ "]" ++
+        ") " ++ l_name ++ "_base[" ++ 
+        (intercalate " + " $ pShowTimeOffset a (DimVAR l_t) ++ 
+                             (zipWith pMul l_dims $ pStrideList l_name l_rank)) ++ "]" ++
         breakline ++ breakline ++ pShowRefMacro l_kernelParams as
 
 pStrideList :: PName -> Int -> [String]
@@ -381,33 +418,85 @@ pShowArrayInfo arrayInUse = foldr pShowArrayInfoItem "" arrayInUse
     where pShowArrayInfoItem l_arrayItem str =
             let l_type = aType l_arrayItem
                 l_name = aName l_arrayItem
-            in  str ++ breakline ++ show l_type ++ " * " ++ l_name ++ "_base"  ++ 
-                " = " ++ l_name ++ ".data();" ++ breakline ++
-                "const int " ++ "l_" ++ l_name ++ "_total_size = " ++ l_name ++
+                -- a Pochoir_SoA_Array has a base pointer per field instead
+                l_base = if aSoA l_arrayItem then ""
+                            else show l_type ++ " * " ++ l_name ++ "_base"  ++ 
+                                 " = " ++ l_name ++ ".data();" ++ breakline
+            in  str ++ breakline ++ l_base ++
+                "const T_index " ++ "l_" ++ l_name ++ "_total_size = " ++ l_name ++
                 ".total_size();" ++ breakline
 
+-- base pointers of all fields of Pochoir_SoA_Array in use
+pShowSoAFields :: [(PArray, PName)] -> String
+pShowSoAFields [] = ""
+pShowSoAFields fL = concat $ map pShowSoAField fL
+    where pShowSoAField (l_array, l_field) =
+            let l_traits = "Pochoir_SoA_Traits<" ++ show (aType l_array) ++ ">::"
+                l_fieldType = l_traits ++ "type_" ++ l_field ++ " *"
+            in  breakline ++ l_fieldType ++ " " ++ pSoAFieldBase (aName l_array) l_field ++ 
+                " = (" ++ l_fieldType ++ ") " ++ aName l_array ++ ".field_data(" ++ 
+                l_traits ++ "field_" ++ l_field ++ ");"
+
+pSoAFieldBase :: PName -> PName -> String
+pSoAFieldBase a f = a ++ "_" ++ f ++ "_base"
+
+getSoAField :: PArray -> Expr -> [(PArray, PName)]
+getSoAField arrayInUse (SVAR t (PVAR q v dL) "." f) =
+    if aSoA arrayInUse then [(arrayInUse, f)] else []
+getSoAField arrayInUse _ = []
+
+getSoAFields :: PKernel -> [(PArray, PName)]
+getSoAFields l_kernel = getFromStmts getSoAField (transArrayMap $ unionArrayIter $ kIter l_kernel) (kStmt l_kernel)
+
 pShowStrides :: Int -> [PArray] -> String
 pShowStrides n [] = ""
-pShowStrides n aL@(a:as) = "const int " ++ getStrides n aL ++ ";\n"
+pShowStrides n aL@(a:as) = "const T_index " ++ getStrides n aL ++ ";\n"
     where getStrides n aL@(a:as) = intercalate ", " $ concat $ map (getStride n) aL
           getStride 1 a = let r = 0 
                           in  ["l_stride_" ++ (aName a) ++ "_" ++ show r ++
-                              " = " ++ (aName a) ++ ".stride(" ++ show r ++ ")"]
+                              " = " ++ pArrayStride a r]
           getStride n a = let r = n-1
                           in  ["l_stride_" ++ (aName a) ++ "_" ++ show r ++
-                              " = " ++ (aName a) ++ ".stride(" ++ show r ++ ")"] ++
+                              " = " ++ pArrayStride a r] ++
                               getStride (n-1) a
 
+-- a broadcast dimension has the literal stride 0, so that the C++ compiler
+-- folds the pointer steps and holds the loads loop-invariant along it.
+-- The dimension is a template argument, so that a bricked or Morton-ordered
+-- array, which has no stride along dimensions 1 and up, fails to compile
+-- with the pointer kernels, not at run time
+pArrayStride :: PArray -> Int -> String
+pArrayStride a r
+    | pBroadcastDim a r = "0"
+    | otherwise = aName a ++ ".template stride<" ++ show r ++ ">()"
+
+-- dimension r (0 is the innermost) of a Pochoir_Const_Array declared with 
+-- the literal size 1, e.g. Pochoir_Const_Array<double, 3> prof(N, 1, 1)
+pBroadcastDim :: PArray -> Int -> Bool
+pBroadcastDim a r = aConst a && length (aDims a) == aRank a && 
+                    aDims a !! (aRank a - 1 - r) == DimINT 1
+
 pShowPointers :: [Iter] -> String
 pShowPointers [] = ""
 pShowPointers iL@(i:is) = foldr pShowPointer "" iL
     where pShowPointer (nameIter, arrayInUse, dL) str =
-                str ++ breakline ++ (show $ aType arrayInUse) ++ " * " ++ nameIter ++ ";"
+                str ++ breakline ++ pShowPointerType arrayInUse ++ nameIter ++ ";"
+
+-- iterators of a Pochoir_SoA_Array are linear offsets shared by all fields
+pShowPointerType :: PArray -> String
+pShowPointerType a 
+    | aSoA a = "T_index "
+    | otherwise = (show $ aType a) ++ " * "
+
+pShowPointerBase :: PArray -> String
+pShowPointerBase a
+    | aSoA a = ""
+    | otherwise = aName a ++ "_base + "
 
 pShowPointerStmt :: PKernel -> String
 pShowPointerStmt l_kernel = 
-    let oldStmts = kStmt l_kernel
-        l_iter = kIter l_kernel
+    let l_iter = kIter l_kernel
+        oldStmts = pConstTimeStmts l_iter $ kStmt l_kernel
         obaseStmts = transStmts oldStmts $ transPointer l_iter
     in show obaseStmts
 
@@ -420,19 +509,45 @@ pShowObaseStmt l_kernel =
 
 pShowOptPointerStmt :: PKernel -> String
 pShowOptPointerStmt l_kernel = 
-    let oldStmts = kStmt l_kernel
-        l_iter = kIter l_kernel
+    let l_iter = kIter l_kernel
+        oldStmts = pConstTimeStmts l_iter $ kStmt l_kernel
         obaseStmts = transStmts oldStmts $ transOptPointer l_iter
     in show obaseStmts
 
 transOptPointer :: [Iter] -> Expr -> Expr
+transOptPointer l_iters (SVAR t (PVAR q v dL) "." f) =
+    case pIterLookup (v, dL) l_iters of
+        Just iterName | isSoAArray v l_iters -> BVAR (pSoAFieldBase v f) (DimVAR iterName)
+        _ -> SVAR t (PVAR q v dL) "." f
 transOptPointer l_iters (PVAR q v dL) =
     case pIterLookup (v, dL) l_iters of
         Nothing -> PVAR q v dL
+        -- a whole struct of a Pochoir_SoA_Array goes through the proxy
+        Just iterName | isSoAArray v l_iters -> PVAR q v dL
         Just iterName -> VAR q $ "(*" ++ iterName ++ ")"
 transOptPointer l_iters e = e
 
+isSoAArray :: PName -> [Iter] -> Bool
+isSoAArray v l_iters = or [aSoA a | (_, a, _) <- l_iters, aName a == v]
+
+-- a Pochoir_Const_Array is accessed without time index, the pointer modes 
+-- give it a time index of 0 so that its iterators are looked up, set and
+-- stepped the same way as the ones of a Pochoir_Array
+transConstTime :: [PArray] -> Expr -> Expr
+transConstTime l_arrays (PVAR q v dL) 
+    | or [aConst a | a <- l_arrays, aName a == v] = PVAR q v (DimINT 0 : dL)
+    | otherwise = PVAR q v dL
+transConstTime l_arrays e = e
+
+pConstTimeStmts :: [Iter] -> [Stmt] -> [Stmt]
+pConstTimeStmts l_iters l_stmts = transStmts l_stmts $ transConstTime $ unionArrayIter l_iters
+
 transPointer :: [Iter] -> Expr -> Expr
+transPointer l_iters (SVAR t (PVAR q v dL) "." f) =
+    case transPointer l_iters (PVAR q v dL) of
+        BVAR iterName de | isSoAArray v l_iters -> 
+            BVAR (pSoAFieldBase v f) (simplifyDimExpr $ DimDuo "+" (DimVAR iterName) de)
+        _ -> SVAR t (PVAR q v dL) "." f
 transPointer l_iters (PVAR q v dL) =
     case pPointerLookup (v, dL) l_iters of
         Nothing -> PVAR q v dL
@@ -492,17 +607,13 @@ pShowOptPointerSet iL@(i:is) l_kernelParams =
     in  pShowPointers baseIters ++ (concat $ map pShowOptPointerSetTerm baseIters) ++ pShowNonBaseIters baseIters iL
         where pShowOptPointerSetTerm (iterName, array, dim) = 
                 let l_arrayName = aName array
-                    l_arrayBaseName = l_arrayName ++ "_base"
-                    l_arrayTotalSize = "l_" ++ l_arrayName ++ "_total_size"
                     l_arrayStrideList = 
                         pGetArrayStrideList (length l_kernelParams - 1) l_arrayName
                     l_transDimList = tail $ pShowTransDim dim l_kernelParams
                     l_arraySpaceOffset = 
                         intercalate " + " $ zipWith pCombineDim l_transDimList l_arrayStrideList
-                    l_arrayTimeOffset = (pGetTimeOffset (aToggle array) (head dim)) ++ 
-                                        " * " ++ l_arrayTotalSize
-                in  breakline ++ iterName ++ " = " ++ l_arrayBaseName ++ " + " ++ 
-                    l_arrayTimeOffset ++ " + " ++ l_arraySpaceOffset ++ ";" 
+                in  breakline ++ iterName ++ " = " ++ pShowPointerBase array ++ 
+                    (intercalate " + " $ pShowTimeOffset array (head dim) ++ [l_arraySpaceOffset]) ++ ";" 
 
 pShowNonBaseIters :: [Iter] -> [Iter] -> String
 pShowNonBaseIters _ [] = ""
@@ -536,27 +647,68 @@ pShowPointerSet [] _ = ""
 pShowPointerSet iL@(i:is) l_kernelParams = concat $ map pShowPointerSetTerm iL
     where pShowPointerSetTerm (iterName, array, dim) = 
             let l_arrayName = aName array
-                l_arrayBaseName = l_arrayName ++ "_base"
-                l_arrayTotalSize = "l_" ++ l_arrayName ++ "_total_size"
                 l_arrayStrideList = 
                     pGetArrayStrideList (length l_kernelParams - 1) l_arrayName
                 l_transDimList = tail $ pShowTransDim dim l_kernelParams
                 l_arraySpaceOffset = 
                     intercalate " + " $ zipWith pCombineDim l_transDimList l_arrayStrideList
-                l_arrayTimeOffset = (pGetTimeOffset (aToggle array) (head dim)) ++ 
-                                    " * " ++ l_arrayTotalSize
-            in  breakline ++ iterName ++ " = " ++ l_arrayBaseName ++ " + " ++ 
-                l_arrayTimeOffset ++ " + " ++ l_arraySpaceOffset ++ ";" 
+            in  breakline ++ iterName ++ " = " ++ pShowPointerBase array ++ 
+                (intercalate " + " $ pShowTimeOffset array (head dim) ++ [l_arraySpaceOffset]) ++ ";" 
+
+-- offset tables of dimensions 1 .. l_rank-1 of all arrays in use
+pShowLayoutOffsets :: Int -> [PArray] -> String
+pShowLayoutOffsets l_rank aL = concat [pShowLayoutOffset a r | a <- aL, r <- [1..l_rank-1], 
+                                                             not $ pBroadcastDim a r]
+    where pShowLayoutOffset a r = 
+            breakline ++ "T_index const * " ++ pLayoutOffset (aName a) r ++
+            " = " ++ aName a ++ ".layout_offset(" ++ show r ++ ");"
+
+pLayoutOffset :: PName -> Int -> String
+pLayoutOffset a r = "l_off_" ++ a ++ "_" ++ show r
+
+-- set all iterators to the start of the current row, 
+-- PName : list of kernel parameters
+pShowLayoutPointerSet :: [Iter] -> [PName] -> String
+pShowLayoutPointerSet iL l_kernelParams = concat $ map pShowLayoutPointerSetTerm iL
+    where l_rank = length l_kernelParams - 1
+          l_inner = last l_kernelParams
+          pShowLayoutPointerSetTerm (iterName, array, dim) =
+            let l_arrayName = aName array
+                -- a broadcast dimension adds nothing
+                l_outerOffset = [pLayoutOffsetTerm l_arrayName r d | 
+                                 (r, d) <- zip [l_rank-1, l_rank-2 .. 1] (init $ tail dim),
+                                 not $ pBroadcastDim array r]
+                l_rowOffset = "(" ++ show (substDimVar l_inner "l_grid.x0[0]" (last dim)) ++ 
+                              ") * " ++ pRowStride l_arrayName
+            in  breakline ++ iterName ++ " = " ++ pShowPointerBase array ++ 
+                (intercalate " + " $ pShowTimeOffset array (head dim) ++ l_outerOffset ++ [l_rowOffset]) ++ ";"
+          pLayoutOffsetTerm a r d = pLayoutOffset a r ++ "[" ++ show d ++ "]"
+
+substDimVar :: PName -> String -> DimExpr -> DimExpr
+substDimVar p s (DimVAR v) 
+    | v == p = DimVAR s
+    | otherwise = DimVAR v
+substDimVar p s (DimDuo bop e1 e2) = DimDuo bop (substDimVar p s e1) (substDimVar p s e2)
+substDimVar p s (DimParen e) = DimParen (substDimVar p s e)
+substDimVar p s e = e
+
+-- offset of the time plane of an access to array a, none for the single
+-- plane of a Pochoir_Const_Array
+pShowTimeOffset :: PArray -> DimExpr -> [String]
+pShowTimeOffset a tDim
+    | aConst a = []
+    | otherwise = [pGetTimeOffset (aToggle a) tDim ++ " * l_" ++ aName a ++ "_total_size"]
 
 pGetTimeOffset :: Int -> DimExpr -> String
 pGetTimeOffset toggle tDim 
-    | toggle == 2 = "((" ++ show tDim ++ ")" ++ " & 0x1" ++ ")"
-    | toggle == 4 = "((" ++ show tDim ++ ")" ++ " & 0x11" ++ ")"
+    | isPowerOf2 toggle = "((" ++ show tDim ++ ") & " ++ show (toggle - 1) ++ ")"
     | otherwise = "((" ++ show tDim ++ ") % " ++ show toggle ++ ")"
+    where isPowerOf2 1 = True
+          isPowerOf2 n = n > 1 && n `mod` 2 == 0 && isPowerOf2 (n `div` 2)
 
 pCombineDim :: DimExpr -> String -> String
 -- l_stride_pa_0 may NOT necessary be "1", 
--- plus that we have already set all strides to be of type "const int"
+-- plus that we have already set all strides to be of type "const T_index"
 pCombineDim de stride = "(" ++ show de ++ ") * " ++ stride
 
 pGetArrayStrideList :: Int -> PName -> [String]
@@ -638,7 +790,7 @@ pShowPointerForHeader 1 iL pL =
                            breakline ++ pShowForHeader 0 (unionArrayIter iL) pL ++  
                            pShowIterComma iL ++
                            breakline ++ intercalate (", " ++ breakline) 
-                                        (map ((++) "++" . getIterName) iL) ++ ") {"
+                                        (map pShowIterInc iL) ++ ") {"
 --                                        (map ((flip (++) "+=1") . getIterName) iL) ++ ") {"
 
 pShowPointerForHeader n iL pL = 
@@ -651,6 +803,14 @@ pShowPointerForHeader n iL pL =
                            ") {" ++ pShowPointerForHeader (n-1) iL pL
     where wrapIterInc gap iter = iter ++ " += " ++ gap 
 
+-- dimension 0 has unit stride unless the array is interleaved with others
+-- (Pochoir::Register_Array_Group), so step by the stride of the array
+pShowIterInc :: Iter -> String
+pShowIterInc (iterName, array, _) = iterName ++ " += " ++ pRowStride (aName array)
+
+pRowStride :: PName -> String
+pRowStride a = "l_stride_" ++ a ++ "_0"
+
 pShowIterComma :: [Iter] -> String
 pShowIterComma [] = ""
 pShowIterComma iL@(i:is) = ", "
@@ -0,0 +1,49 @@
+#!/bin/bash
+# compare the fork-join backends of the walkers (Cilk Plus, the built-in
+# work-stealing scheduler on std::thread, OpenMP tasks and TBB) on
+# tb_heat_2D_NP, tb_heat_3D_NP and tb_3dfd, for 1 up to $max_p workers
+# usage : ./run_backend_cmp.sh [max_p] (in the directory of pochoir and the examples)
+#   - backends which fail to build (e.g. no TBB around) are skipped
+
+file="tb_heat_2D_NP tb_heat_3D_NP tb_3dfd"
+backend="cilk threads openmp tbb"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+tstep=100
+
+flags() {
+    case $1 in
+    cilk)    echo "-DPOCHOIR_BACKEND=POCHOIR_BACKEND_CILK";;
+    threads) echo "-DPOCHOIR_BACKEND=POCHOIR_BACKEND_THREADS -pthread";;
+    openmp)  echo "-DPOCHOIR_BACKEND=POCHOIR_BACKEND_OPENMP -fopenmp";;
+    tbb)     echo "-DPOCHOIR_BACKEND=POCHOIR_BACKEND_TBB -ltbb";;
+    esac
+}
+
+args() {
+    case $1 in
+    tb_heat_2D_NP) echo "4000 $tstep";;
+    tb_heat_3D_NP) echo "400 $tstep";;
+    tb_3dfd)       echo "400 400 400 $tstep";;
+    esac
+}
+
+set -x
+for f in $file; do
+    for b in $backend; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x `flags $b` $f".cpp" -o $f"_"$b
+    done
+done
+set +x
+
+for f in $file; do
+    for ((p = 1; p <= $max_p; p += ${p})) do
+        echo "$f `args $f` : $p workers"
+        for b in $backend; do
+            if [ -x $f"_"$b ]; then
+                echo -n "$b : "
+                CILK_NWORKERS=$p POCHOIR_NWORKERS=$p OMP_NUM_THREADS=$p \
+                    ./$f"_"$b `args $f` 2>&1 | grep "Pochoir ET"
+            fi
+        done
+    done
+done
@@ -0,0 +1,22 @@
+#!/bin/bash
+# compare the boundary function registered as a function pointer (default)
+# and as the boundary type of the array (-DBOUNDARY_FN_TYPE=1)
+# usage : ./run_bv_cmp.sh (in the directory of pochoir and the examples)
+
+file="tb_heat_2D_NP"
+tstep=1000
+
+set -x
+for f in $file; do
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DBOUNDARY_FN_TYPE=0 $f".cpp" -o $f"_ptr"
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DBOUNDARY_FN_TYPE=1 $f".cpp" -o $f"_type"
+done
+set +x
+
+for ((size = 100; size <= 1600; size += ${size})) do
+    for f in $file; do
+        echo "$f $size $tstep"
+        ./$f"_ptr" $size $tstep | grep "Pochoir ET"
+        ./$f"_type" $size $tstep | grep "Pochoir ET"
+    done
+done
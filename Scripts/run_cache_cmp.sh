@@ -0,0 +1,35 @@
+#!/bin/bash
+# compare the fixed stopping sizes of the walkers (POCHOIR_CACHE_LEVEL=0)
+# with base cases sized to the L1, L2 or L3 cache of one core, on 
+# tb_heat_2D_NP, tb_heat_3D_NP, tb_heat_4D_NP and tb_3dfd
+# usage : ./run_cache_cmp.sh [p] (in the directory of pochoir and the examples)
+
+file="tb_heat_2D_NP tb_heat_3D_NP tb_heat_4D_NP tb_3dfd"
+level="0 1 2 3"
+p=${1:-`getconf _NPROCESSORS_ONLN`}
+tstep=100
+
+args() {
+    case $1 in
+    tb_heat_2D_NP) echo "4000 $tstep";;
+    tb_heat_3D_NP) echo "400 $tstep";;
+    tb_heat_4D_NP) echo "60 $tstep";;
+    tb_3dfd)       echo "400 400 400 $tstep";;
+    esac
+}
+
+set -x
+for f in $file; do
+    for l in $level; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x -DPOCHOIR_CACHE_LEVEL=$l $f".cpp" -o $f"_L"$l
+    done
+done
+set +x
+
+for f in $file; do
+    echo "$f `args $f` : $p workers"
+    for l in $level; do
+        echo -n "POCHOIR_CACHE_LEVEL=$l : "
+        CILK_NWORKERS=$p POCHOIR_NWORKERS=$p ./$f"_L"$l `args $f` 2>&1 | grep "Pochoir ET"
+    done
+done
@@ -0,0 +1,41 @@
+#!/bin/bash
+# compare the level-synchronous hyperspace cut (one cilk_sync per
+# dependency level) with the dataflow one (-DPOCHOIR_DATAFLOW=1) on
+# tb_heat_3D_NP and tb_heat_4D_NP : work/span from cilkview, then the
+# running time for 1 up to $max_p workers
+# usage : ./run_dataflow_span.sh [max_p] (in the directory of pochoir and the examples)
+
+file="tb_heat_3D_NP tb_heat_4D_NP"
+mode="0 1"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+tstep=200
+
+sizes() {
+    case $1 in
+    tb_heat_3D_NP) echo "100 200 400";;
+    tb_heat_4D_NP) echo "25 50 100";;
+    esac
+}
+
+set -x
+for f in $file; do
+    for m in $mode; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x -DPOCHOIR_DATAFLOW=$m $f".cpp" -o $f"_df"$m
+    done
+done
+set +x
+
+for f in $file; do
+    for size in `sizes $f`; do
+        for m in $mode; do
+            echo "cilkview -- $f POCHOIR_DATAFLOW=$m $size $tstep"
+            cilkview ./$f"_df"$m $size $tstep 2>&1 | grep -E "Work :|Span :|Parallelism :"
+        done
+        for ((p = 1; p <= $max_p; p += ${p})) do
+            for m in $mode; do
+                echo -n "$f POCHOIR_DATAFLOW=$m $size $tstep : $p workers : "
+                CILK_NWORKERS=$p POCHOIR_NWORKERS=$p ./$f"_df"$m $size $tstep 2>&1 | grep "Pochoir ET"
+            done
+        done
+    done
+done
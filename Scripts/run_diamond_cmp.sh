@@ -0,0 +1,40 @@
+#!/bin/bash
+# compare the diamond tiles (POCHOIR_WALK_DIAMOND) head to head with the
+# trapezoidal decomposition of shorter_duo_sim_obase_bicut (POCHOIR_WALK_TRAP)
+# on tb_heat_2D_NP, tb_heat_3D_NP, tb_heat_4D_NP, tb_3d7pt and tb_3dfd,
+# a deep and a wide-but-shallow problem each, for 1 up to $max_p workers
+# usage : ./run_diamond_cmp.sh [max_p] (in the directory of pochoir and the examples)
+
+file="tb_heat_2D_NP tb_heat_3D_NP tb_heat_4D_NP tb_3d7pt tb_3dfd"
+walk="TRAP DIAMOND"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+
+# one problem per line
+args() {
+    case $1 in
+    tb_heat_2D_NP) echo "4000 500"; echo "16000 20";;
+    tb_heat_3D_NP) echo "400 100"; echo "1000 10";;
+    tb_heat_4D_NP) echo "60 100"; echo "120 10";;
+    tb_3d7pt)      echo "400 400 400 100"; echo "1000 1000 200 10";;
+    tb_3dfd)       echo "400 400 400 100"; echo "1000 1000 200 10";;
+    esac
+}
+
+set -x
+for f in $file; do
+    for w in $walk; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x -DPOCHOIR_DEFAULT_WALK=POCHOIR_WALK_$w $f".cpp" -o $f"_"$w
+    done
+done
+set +x
+
+for f in $file; do
+    args $f | while read size; do
+        for ((p = 1; p <= $max_p; p += ${p})) do
+            for w in $walk; do
+                echo -n "$f $size : $p workers : POCHOIR_WALK_$w : "
+                CILK_NWORKERS=$p POCHOIR_NWORKERS=$p ./$f"_"$w $size 2>&1 | grep "Pochoir ET"
+            done
+        done
+    done
+done
@@ -0,0 +1,24 @@
+#!/bin/bash
+# price $ne American put options (apop) as one ensemble (-n, the option
+# index as a dimension of slope 0) against one Pochoir run per option,
+# for a few grid sizes and 1 up to $max_p workers
+# usage : ./run_ensemble_cmp.sh [max_p] [ne] (in the directory of pochoir and the examples)
+
+file="apop"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+ne=${2:-4096}
+
+sizes() {
+    echo "-s 100 -t 100"; echo "-s 400 -t 400"; echo "-s 1000 -t 100"
+}
+
+set -x
+./pochoir -O3 -DNDEBUG -std=c++0x $file".cpp" -o $file
+set +x
+
+sizes | while read size; do
+    for ((p = 1; p <= $max_p; p += ${p})) do
+        echo "$file -n $ne $size : $p workers : "
+        CILK_NWORKERS=$p POCHOIR_NWORKERS=$p ./$file -n $ne $size 2>&1 | grep -E "difference|Running time"
+    done
+done
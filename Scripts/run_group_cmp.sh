@@ -0,0 +1,25 @@
+#!/bin/bash
+# compare separate storage against interleaved (grouped) storage of the
+# arrays registered to one Pochoir object, on rna and psa_struct
+# usage : ./run_group_cmp.sh (in the directory of pochoir and the examples)
+
+file="rna psa_struct"
+
+set -x
+for f in $file; do
+    ./pochoir -O3 -DNDEBUG -std=c++0x $f".cpp" -o $f"_sep"
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DGROUP_STORAGE=1 $f".cpp" -o $f"_grp"
+done
+set +x
+
+for ((size = 100; size <= 1600; size += ${size})) do
+    echo "rna -r $size"
+    ./rna_sep -r $size
+    ./rna_grp -r $size
+done
+
+for ((size = 1000; size <= 128000; size += ${size})) do
+    echo "psa_struct -r $size $size"
+    ./psa_struct_sep -r $size $size
+    ./psa_struct_grp -r $size $size
+done
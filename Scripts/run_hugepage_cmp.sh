@@ -0,0 +1,31 @@
+#!/bin/bash
+# compare small pages (default) and 2MB huge pages for the toggle buffers
+# of tb_heat_3D_NP and tb_heat_4D_NP, with the dTLB misses if perf is around
+# usage : ./run_hugepage_cmp.sh (in the directory of pochoir and the examples)
+
+file="tb_heat_3D_NP tb_heat_4D_NP"
+tstep=100
+if which perf > /dev/null 2>&1; then
+    prof="perf stat -e dTLB-load-misses,dTLB-store-misses"
+else
+    prof=""
+fi
+
+set -x
+for f in $file; do
+    ./pochoir -O3 -DNDEBUG -std=c++0x $f".cpp" -o $f"_small"
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DPOCHOIR_DEFAULT_PAGE=POCHOIR_PAGE_HUGE_2M $f".cpp" -o $f"_huge"
+done
+set +x
+
+for ((size = 100; size <= 800; size += ${size})) do
+    echo "tb_heat_3D_NP $size $tstep"
+    $prof ./tb_heat_3D_NP_small $size $tstep 2>&1 | grep "Pochoir ET\|dTLB"
+    $prof ./tb_heat_3D_NP_huge $size $tstep 2>&1 | grep "Pochoir ET\|Pochoir huge\|dTLB"
+done
+
+for ((size = 25; size <= 100; size += ${size})) do
+    echo "tb_heat_4D_NP $size $tstep"
+    $prof ./tb_heat_4D_NP_small $size $tstep 2>&1 | grep "Pochoir ET\|dTLB"
+    $prof ./tb_heat_4D_NP_huge $size $tstep 2>&1 | grep "Pochoir ET\|Pochoir huge\|dTLB"
+done
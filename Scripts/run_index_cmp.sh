@@ -0,0 +1,26 @@
+#!/bin/bash
+# compare 32-bit (-DLONG_INDEX=0) and 64-bit (default) array indexing
+# on grids small enough for both
+# usage : ./run_index_cmp.sh (in the directory of pochoir and the examples)
+
+file="tb_heat_2D_NP tb_heat_3D_NP"
+tstep=1000
+
+set -x
+for f in $file; do
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DLONG_INDEX=0 $f".cpp" -o $f"_int"
+    ./pochoir -O3 -DNDEBUG -std=c++0x -DLONG_INDEX=1 $f".cpp" -o $f"_long"
+done
+set +x
+
+for ((size = 100; size <= 1600; size += ${size})) do
+    echo "tb_heat_2D_NP $size $tstep"
+    ./tb_heat_2D_NP_int $size $tstep | grep "Pochoir ET"
+    ./tb_heat_2D_NP_long $size $tstep | grep "Pochoir ET"
+done
+
+for ((size = 50; size <= 400; size += ${size})) do
+    echo "tb_heat_3D_NP $size $tstep"
+    ./tb_heat_3D_NP_int $size $tstep | grep "Pochoir ET"
+    ./tb_heat_3D_NP_long $size $tstep | grep "Pochoir ET"
+done
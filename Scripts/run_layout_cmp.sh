@@ -0,0 +1,26 @@
+#!/bin/bash
+# compare the row-major, bricked and Morton-ordered layouts of the toggle 
+# buffers on the 3D examples, all compiled with -split-opt-pointer, which is
+# the pointer mode that goes through the layout offset tables
+# usage : ./run_layout_cmp.sh (in the directory of pochoir and the examples)
+
+file="tb_3d7pt tb_3d27pt tb_3dfd"
+layout="DENSE BRICK MORTON"
+tstep=100
+
+set -x
+for f in $file; do
+    for l in $layout; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x -split-opt-pointer -DPOCHOIR_DEFAULT_LAYOUT=POCHOIR_LAYOUT_$l $f".cpp" -o $f"_"$l
+    done
+done
+set +x
+
+for ((size = 100; size <= 800; size += ${size})) do
+    for f in $file; do
+        for l in $layout; do
+            echo "$f $l $size $tstep"
+            ./$f"_"$l $size $size $size $tstep | grep "Pochoir ET\|FAILED" | head -3
+        done
+    done
+done
@@ -0,0 +1,23 @@
+#!/bin/bash
+# compare the heap-backed (default) and the mmap'd-file-backed toggle buffer
+# of tb_heat_3D_NP
+# usage : ./run_mmap_cmp.sh [dir of backing file] (in the directory of 
+# pochoir and the examples)
+
+dir=${1:-/tmp}
+tstep=100
+
+set -x
+./pochoir -O3 -DNDEBUG -std=c++0x tb_heat_3D_NP.cpp -o tb_heat_3D_NP
+set +x
+
+for ((size = 50; size <= 800; size += ${size})) do
+    echo "tb_heat_3D_NP $size $tstep : heap"
+    ./tb_heat_3D_NP $size $tstep | grep "Pochoir ET"
+    rm -f $dir/heat_3D_$size.dat
+    echo "tb_heat_3D_NP $size $tstep : mmap (fresh file)"
+    ./tb_heat_3D_NP $size $tstep $dir/heat_3D_$size.dat | grep "Pochoir ET"
+    echo "tb_heat_3D_NP $size $tstep : mmap (re-mapped file)"
+    ./tb_heat_3D_NP $size $tstep $dir/heat_3D_$size.dat | grep "Pochoir ET"
+    rm -f $dir/heat_3D_$size.dat
+done
@@ -0,0 +1,39 @@
+#!/bin/bash
+# compare random work stealing over the whole machine (POCHOIR_NUMA=0)
+# with one slab per NUMA node, node-pinned workers and node-local first
+# touch (POCHOIR_NUMA=1), on the built-in scheduler (POCHOIR_BACKEND_THREADS),
+# on tb_heat_2D_NP, tb_heat_3D_NP and tb_3dfd, for 1 up to $max_p workers
+# usage : ./run_numa_cmp.sh [max_p] (in the directory of pochoir and the examples)
+#   - POCHOIR_NUMA_NODES=k in the environment splits the cpus into k nodes
+#     instead of the nodes of sysfs
+
+file="tb_heat_2D_NP tb_heat_3D_NP tb_3dfd"
+mode="0 1"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+tstep=100
+
+args() {
+    case $1 in
+    tb_heat_2D_NP) echo "16000 $tstep";;
+    tb_heat_3D_NP) echo "800 $tstep";;
+    tb_3dfd)       echo "800 800 800 $tstep";;
+    esac
+}
+
+set -x
+for f in $file; do
+    for m in $mode; do
+        ./pochoir -O3 -DNDEBUG -std=c++0x -DPOCHOIR_BACKEND=POCHOIR_BACKEND_THREADS -pthread -DPOCHOIR_NUMA=$m $f".cpp" -o $f"_numa"$m
+    done
+done
+set +x
+
+for f in $file; do
+    for ((p = 1; p <= $max_p; p += ${p})) do
+        echo "$f `args $f` : $p workers"
+        for m in $mode; do
+            echo -n "POCHOIR_NUMA=$m : "
+            POCHOIR_NWORKERS=$p ./$f"_numa"$m `args $f` 2>&1 | grep "Pochoir ET"
+        done
+    done
+done
@@ -0,0 +1,37 @@
+#!/bin/bash
+# compare the default recursion thresholds with the ones found by the 
+# autotuner, on tb_heat_3D_NP, tb_heat_4D_NP and tb_3dfd
+# usage : ./run_tune_cmp.sh [max_p] (in the directory of pochoir and the examples)
+#   - the thresholds go to a scratch database, pochoir_tune_cmp.db
+
+file="tb_heat_3D_NP tb_heat_4D_NP tb_3dfd"
+max_p=${1:-`getconf _NPROCESSORS_ONLN`}
+tstep=100
+export POCHOIR_TUNE_DB=pochoir_tune_cmp.db
+
+args() {
+    case $1 in
+    tb_heat_3D_NP) echo "400 $tstep";;
+    tb_heat_4D_NP) echo "60 $tstep";;
+    tb_3dfd)       echo "400 400 400 $tstep";;
+    esac
+}
+
+set -x
+for f in $file; do
+    ./pochoir -O3 -DNDEBUG -std=c++0x $f".cpp" -o $f
+done
+set +x
+
+rm -f $POCHOIR_TUNE_DB
+for f in $file; do
+    for ((p = 1; p <= $max_p; p += ${p})) do
+        export CILK_NWORKERS=$p POCHOIR_NWORKERS=$p
+        echo "$f `args $f` : $p workers"
+        echo -n "default : "
+        ./$f `args $f` 2>&1 | grep "Pochoir ET"
+        POCHOIR_TUNE=1 ./$f `args $f` 2>&1 | grep "Pochoir tuning"
+        echo -n "tuned : "
+        ./$f `args $f` 2>&1 | grep "Pochoir ET"
+    done
+done
@@ -26,14 +26,28 @@
 #ifndef EXPR_STENCIL_HPP
 #define EXPR_STENCIL_HPP
 
+#include <memory>
+#include <functional>
 #include "pochoir_common.hpp"
 #include "pochoir_array.hpp"
+#include "pochoir_soa_array.hpp"
+#include "pochoir_const_array.hpp"
+#include "pochoir_tune.hpp"
+#include "pochoir_async.hpp"
 /* assuming there won't be more than 10 Pochoir_Array in one Pochoir object! */
 #define ARRAY_SIZE 10
-template <int N_RANK>
+/* TOGGLE has to match the time depth of the shape, 
+ * as well as the toggle of all registered Pochoir_Arrays
+ */
+template <int N_RANK, int TOGGLE = 2>
 class Pochoir {
     private:
         int slope_[N_RANK];
+        /* how far a zoid side has to lean on dimension i : slope0_ toward
+         * x0 (the reads of lower indices), slope1_ toward x1; slope_ is 
+         * the larger of the two
+         */
+        int slope0_[N_RANK], slope1_[N_RANK];
         grid_info<N_RANK> logic_grid_;
         grid_info<N_RANK> phys_grid_;
         int time_shift_;
@@ -44,20 +58,57 @@ class Pochoir {
         void checkFlags(void);
         template <typename T_Array>
         void getPhysDomainFromArray(T_Array & arr);
+        /* _broadcast : a dimension of size 1 matches any size */
         template <typename T_Array>
-        void cmpPhysDomainFromArray(T_Array & arr);
+        void cmpPhysDomainFromArray(T_Array & arr, bool _broadcast = false);
         template <size_t N_SIZE>
         void Register_Shape(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]);
         Pochoir_Shape<N_RANK> * shape_;
         int shape_size_;
         int num_arr_;
         int arr_type_size_;
+        /* bytes per grid point of all registered arrays, all time planes */
+        int cell_bytes_;
+        void const * arr_[ARRAY_SIZE];
+        bool add_cell_bytes(void const * arr, int bytes);
+        /* copies of the arrays the kernels write, see Pochoir_Array::backup(),
+         * which tune() puts back after each trial run; the set is of the 
+         * storages copied so far, which the members of a group share
+         */
+        std::vector<std::function<std::function<void ()> (std::set<void const *> &)> > backup_;
+        Pochoir_Walk_Type walk_;
+        /* thresholds of the tuning database for the problem of tuneKey_,
+         * or the candidate of the autotuner while tuning_
+         */
+        thres_info<N_RANK> thres_;
+        std::string tuneKey_;
+        bool tuneFound_, tuning_;
+        std::string tune_key(char const * walker);
+        template <typename Fn>
+        void set_thres(Algorithm<N_RANK> & algor, char const * walker, bool boundary, int timestep, Fn const & run);
+        template <typename Fn>
+        void tune(char const * walker, bool boundary, int timestep, Fn const & run);
+        /* the walker kept from one Run to the next, set up for 'algorWalker_'
+         * (NULL once a registration or the tuner changed what it was set up
+         * for), and the time step the next Run starts from
+         */
+        std::unique_ptr<Algorithm<N_RANK> > algor_;
+        char const * algorWalker_;
+        int time_;
+        Pochoir_End_Type runEnd_;
+        template <typename Fn>
+        Algorithm<N_RANK> & algorithm(char const * walker, bool boundary, int timestep, Fn const & run);
+        int band_height(void);
+        template <typename W>
+        void walk(Algorithm<N_RANK> & algor, int timestep, W const & w);
+        /* fill in the writer planes of Register_Snapshot() with plane t */
+        std::vector<std::function<void (int)> > snapshot_;
 
     public:
     template <size_t N_SIZE>
     Pochoir(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]) {
         for (int i = 0; i < N_RANK; ++i) {
-            slope_[i] = 0;
+            slope_[i] = slope0_[i] = slope1_[i] = 0;
             logic_grid_.x0[i] = logic_grid_.x1[i] = logic_grid_.dx0[i] = logic_grid_.dx1[i] = 0;
             phys_grid_.x0[i] = phys_grid_.x1[i] = phys_grid_.dx0[i] = phys_grid_.dx1[i] = 0;
         }
@@ -67,11 +118,29 @@ class Pochoir {
         regShapeFlag = true;
         num_arr_ = 0;
         arr_type_size_ = 0;
+        cell_bytes_ = 0;
+        walk_ = POCHOIR_DEFAULT_WALK;
+        tuneFound_ = tuning_ = false;
+        algorWalker_ = NULL;
+        time_ = 0;
+        runEnd_ = POCHOIR_END_EXACT;
     }
     /* currently, we just compute the slope[] out of the shape[] */
     /* We get the grid_info out of arrayInUse */
+    template <typename T, typename BF, Pochoir_Layout_Type LAYOUT>
+    void Register_Array(Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & arr);
+    template <typename T>
+    void Register_Array(Pochoir_SoA_Array<T, N_RANK, TOGGLE> & arr);
+    /* a read-only field : one plane, and not part of the shape */
     template <typename T>
-    void Register_Array(Pochoir_Array<T, N_RANK> & arr);
+    void Register_Array(Pochoir_Const_Array<T, N_RANK> & arr);
+    /* register arrays of the same element type which are always read 
+     * together, with their elements interleaved grid point by grid point
+     * in one toggle buffer (see Pochoir_Array::group()), so a stencil 
+     * point touches one stream instead of one per array
+     */
+    template <typename T, typename BF, Pochoir_Layout_Type LAYOUT, typename ... Rest>
+    void Register_Array_Group(Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & arr, Rest & ... rest);
 
     /* We should still keep the Register_Domain for zero-padding!!! */
     template <typename Domain>
@@ -109,10 +178,62 @@ class Pochoir {
     /* obase for interior and ExecSpec for boundary */
     template <typename F, typename BF>
     void Run_Obase(int timestep, F const & f, BF const & bf);
+
+    /* the walker of the following Run(timestep, f, bf) and Run_Obase() */
+    void Set_Walk(Pochoir_Walk_Type walk) { walk_ = walk; algor_.reset(); }
+
+    /* a Run goes on from where the previous one stopped : Get_Time() is
+     * the time step the next Run starts from, Set_Time() moves it, e.g. 
+     * back to 0 after the arrays are initialized anew. The walker set up
+     * by the first Run is kept for the following ones, so many short Runs
+     * cost about as much as one long Run
+     */
+    int Get_Time(void) const { return time_; }
+    void Set_Time(int t) { time_ = t; }
+    /* with POCHOIR_END_BAND, a Run may go past 'timestep' steps, to the
+     * end of the band it stops in, which Get_Time() tells
+     */
+    void Set_Run_End(Pochoir_End_Type end) { runEnd_ = end; }
+
+    /* run 'timestep' steps on from Get_Time() in the background, as 
+     * Runs of 'every' steps : run(n) is one of them, 
+     * e.g. [&](int n) { p.Run_Obase(n, f, bf); }
+     * After each, watermark(t) is called with the time step t it ended on,
+     * whose plane of every array is final. It is called on a thread of 
+     * its own if some arrays have a writer plane, which then holds plane
+     * t until watermark(t) returns (see Pochoir_Async), so the next steps
+     * run meanwhile; watermark() must not run Pochoir walks itself.
+     * 'run' and watermark() are copied, the arrays and this object are 
+     * in use until the returned handle is done.
+     */
+    template <typename R, typename W>
+    Pochoir_Async Run_Async(int timestep, int every, R const & run, W const & watermark);
+    /* give 'arr' a writer plane, which Run_Async() fills in for the 
+     * watermark callback to read with arr.snap(i, j, ..)
+     */
+    template <typename T, typename BF, Pochoir_Layout_Type LAYOUT>
+    void Register_Snapshot(Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & arr) {
+        snapshot_.push_back([&arr](int t) { arr.take_snapshot(t); });
+    }
+
+    /* autotuning of the recursion thresholds for Run(timestep, f, bf) 
+     * and Run_Obase() : the stencil is run over and over for 'timestep'
+     * steps from Get_Time() with different thresholds, on the registered
+     * arrays, which are copied before and put back after each trial run,
+     * so they and Get_Time() are left as they were; the fastest 
+     * thresholds are stored in the tuning database (pochoir_tune.hpp),
+     * where later runs of the same problem pick them up
+     */
+    template <typename F, typename BF>
+    void Tune(int timestep, F const & f, BF const & bf);
+    template <typename F>
+    void Tune_Obase(int timestep, F const & f);
+    template <typename F, typename BF>
+    void Tune_Obase(int timestep, F const & f, BF const & bf);
 };
 
-template <int N_RANK>
-void Pochoir<N_RANK>::checkFlag(bool flag, char const * str) {
+template <int N_RANK, int TOGGLE>
+void Pochoir<N_RANK, TOGGLE>::checkFlag(bool flag, char const * str) {
     if (!flag) {
         printf("\nPochoir registration error:\n");
         printf("You forgot to register %s.\n", str);
@@ -120,8 +241,8 @@ void Pochoir<N_RANK>::checkFlag(bool flag, char const * str) {
     }
 }
 
-template <int N_RANK>
-void Pochoir<N_RANK>::checkFlags(void) {
+template <int N_RANK, int TOGGLE>
+void Pochoir<N_RANK, TOGGLE>::checkFlags(void) {
     checkFlag(regArrayFlag, "Pochoir array");
     checkFlag(regLogicDomainFlag, "Logic Domain");
     checkFlag(regPhysDomainFlag, "Physical Domain");
@@ -129,8 +250,8 @@ void Pochoir<N_RANK>::checkFlags(void) {
     return;
 }
 
-template <int N_RANK> template <typename T_Array> 
-void Pochoir<N_RANK>::getPhysDomainFromArray(T_Array & arr) {
+template <int N_RANK, int TOGGLE> template <typename T_Array> 
+void Pochoir<N_RANK, TOGGLE>::getPhysDomainFromArray(T_Array & arr) {
     /* get the physical grid */
     for (int i = 0; i < N_RANK; ++i) {
         phys_grid_.x0[i] = 0; phys_grid_.x1[i] = arr.size(i);
@@ -142,13 +263,14 @@ void Pochoir<N_RANK>::getPhysDomainFromArray(T_Array & arr) {
 
     regPhysDomainFlag = true;
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename T_Array> 
-void Pochoir<N_RANK>::cmpPhysDomainFromArray(T_Array & arr) {
+template <int N_RANK, int TOGGLE> template <typename T_Array> 
+void Pochoir<N_RANK, TOGGLE>::cmpPhysDomainFromArray(T_Array & arr, bool _broadcast) {
     /* check the consistency of all engaged Pochoir_Array */
     for (int j = 0; j < N_RANK; ++j) {
-        if (arr.size(j) != phys_grid_.x1[j]) {
+        if (arr.size(j) != phys_grid_.x1[j] && !(_broadcast && arr.size(j) == 1)) {
             printf("Pochoir array size mismatch error:\n");
             printf("Registered Pochoir arrays have different sizes!\n");
             exit(1);
@@ -156,8 +278,22 @@ void Pochoir<N_RANK>::cmpPhysDomainFromArray(T_Array & arr) {
     }
 }
 
-template <int N_RANK> template <typename T>
-void Pochoir<N_RANK>::Register_Array(Pochoir_Array<T, N_RANK> & arr) {
+/* an array registered twice (e.g. through registerBoundaryFn()) counts once */
+template <int N_RANK, int TOGGLE>
+bool Pochoir<N_RANK, TOGGLE>::add_cell_bytes(void const * arr, int bytes) {
+    for (int i = 0; i < num_arr_ && i < ARRAY_SIZE; ++i) {
+        if (arr_[i] == arr)
+            return false;
+    }
+    if (num_arr_ < ARRAY_SIZE)
+        arr_[num_arr_] = arr;
+    ++num_arr_;
+    cell_bytes_ += bytes;
+    return true;
+}
+
+template <int N_RANK, int TOGGLE> template <typename T, typename BF, Pochoir_Layout_Type LAYOUT>
+void Pochoir<N_RANK, TOGGLE>::Register_Array(Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & arr) {
     if (!regShapeFlag) {
         cout << "Please register Shape before register Array!" << endl;
         exit(1);
@@ -165,11 +301,12 @@ void Pochoir<N_RANK>::Register_Array(Pochoir_Array<T, N_RANK> & arr) {
 
     if (num_arr_ == 0) {
         arr_type_size_ = sizeof(T);
-        ++num_arr_;
 #if DEBUG
         printf("arr_type_size = %d\n", arr_type_size_);
 #endif
     } 
+    if (add_cell_bytes(&arr, sizeof(T) * TOGGLE))
+        backup_.push_back([&arr](std::set<void const *> & _done) { return arr.backup(_done); });
     if (!regPhysDomainFlag) {
         getPhysDomainFromArray(arr);
     } else {
@@ -182,10 +319,82 @@ void Pochoir<N_RANK>::Register_Array(Pochoir_Array<T, N_RANK> & arr) {
     arr.alloc_mem();
 #endif
     regArrayFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <size_t N_SIZE>
-void Pochoir<N_RANK>::Register_Shape(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]) {
+template <int N_RANK, int TOGGLE> template <typename T>
+void Pochoir<N_RANK, TOGGLE>::Register_Array(Pochoir_SoA_Array<T, N_RANK, TOGGLE> & arr) {
+    if (!regShapeFlag) {
+        cout << "Please register Shape before register Array!" << endl;
+        exit(1);
+    }
+
+    /* the same bytes per grid point as an array of T */
+    if (num_arr_ == 0) {
+        arr_type_size_ = sizeof(T);
+#if DEBUG
+        printf("arr_type_size = %d\n", arr_type_size_);
+#endif
+    } 
+    if (add_cell_bytes(&arr, sizeof(T) * TOGGLE))
+        backup_.push_back([&arr](std::set<void const *> & _done) { return arr.backup(_done); });
+    if (!regPhysDomainFlag) {
+        getPhysDomainFromArray(arr);
+    } else {
+        cmpPhysDomainFromArray(arr);
+    }
+    arr.Register_Shape(shape_, shape_size_);
+#if 0
+    arr.set_slope(slope_);
+    arr.set_toggle(toggle_);
+    arr.alloc_mem();
+#endif
+    regArrayFlag = true;
+    algor_.reset();
+}
+
+template <int N_RANK, int TOGGLE> template <typename T>
+void Pochoir<N_RANK, TOGGLE>::Register_Array(Pochoir_Const_Array<T, N_RANK> & arr) {
+    if (!regShapeFlag) {
+        cout << "Please register Shape before register Array!" << endl;
+        exit(1);
+    }
+
+    if (num_arr_ == 0) {
+        arr_type_size_ = sizeof(T);
+#if DEBUG
+        printf("arr_type_size = %d\n", arr_type_size_);
+#endif
+    } 
+    /* a single plane, whatever the toggle of the stencil is, and the
+     * dimensions of size 1 are broadcast over the grid
+     */
+    add_cell_bytes(&arr, sizeof(T));
+    if (!regPhysDomainFlag) {
+        getPhysDomainFromArray(arr);
+    } else {
+        cmpPhysDomainFromArray(arr, true);
+    }
+    arr.set_grid_size(phys_grid_);
+    arr.alloc_mem();
+    regArrayFlag = true;
+    algor_.reset();
+}
+
+template <int N_RANK, int TOGGLE> template <typename T, typename BF, Pochoir_Layout_Type LAYOUT, typename ... Rest>
+void Pochoir<N_RANK, TOGGLE>::Register_Array_Group(Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & arr, Rest & ... rest) {
+    int const l_n = 1 + sizeof...(Rest);
+    int l_k = 0;
+    Storage<T> * l_view = arr.group(NULL, l_k, l_n);
+    /* a braced list is evaluated left to right, so is the member number */
+    int l_group[] = {0, (rest.group(l_view, ++l_k, l_n), 0)...};
+    Register_Array(arr);
+    int l_register[] = {0, (Register_Array(rest), 0)...};
+    (void) l_group; (void) l_register;
+}
+
+template <int N_RANK, int TOGGLE> template <size_t N_SIZE>
+void Pochoir<N_RANK, TOGGLE>::Register_Shape(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]) {
     /* currently we just get the slope_[] and toggle_ out of the shape[] */
     shape_ = new Pochoir_Shape<N_RANK>[N_SIZE];
     shape_size_ = N_SIZE;
@@ -202,23 +411,52 @@ void Pochoir<N_RANK>::Register_Shape(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]) {
     depth = l_max_time_shift - l_min_time_shift;
     time_shift_ = 0 - l_min_time_shift;
     toggle_ = depth + 1;
+    if (toggle_ != TOGGLE) {
+        printf("Pochoir toggle error:\n");
+        printf("The shape has a time depth of %d, which needs Pochoir<%d, %d> instead of Pochoir<%d, %d>!\n", depth, N_RANK, toggle_, N_RANK, TOGGLE);
+        exit(1);
+    }
     for (int i = 0; i < N_SIZE; ++i) {
         for (int r = 1; r < N_RANK+1; ++r) {
             slope_[N_RANK-r] = max(slope_[N_RANK-r], abs((int)ceil((float)shape[i].shift[r]/(l_max_time_shift - shape[i].shift[0]))));
         }
     }
+    /* the one-sided slopes : a read k steps back at shift d < 0 leans the
+     * x0 side by |d|/k, and the x1 side by |d|/(toggle_-k), as the plane
+     * read is overwritten toggle_-k steps later, maybe before the neighbor
+     * across x1 has read it; a shift d > 0 is the mirror image
+     */
+    for (size_t i = 0; i < N_SIZE; ++i) {
+        const int l_k = l_max_time_shift - shape[i].shift[0];
+        if (l_k == 0)
+            continue;
+        for (int r = 1; r < N_RANK+1; ++r) {
+            const int l_d = shape[i].shift[r];
+            const int l_read = (abs(l_d) + l_k - 1) / l_k;
+            const int l_write = (abs(l_d) + toggle_ - l_k - 1) / (toggle_ - l_k);
+            if (l_d < 0) {
+                slope0_[N_RANK-r] = max(slope0_[N_RANK-r], l_read);
+                slope1_[N_RANK-r] = max(slope1_[N_RANK-r], l_write);
+            } else if (l_d > 0) {
+                slope1_[N_RANK-r] = max(slope1_[N_RANK-r], l_read);
+                slope0_[N_RANK-r] = max(slope0_[N_RANK-r], l_write);
+            }
+        }
+    }
+    for (int i = 0; i < N_RANK; ++i)
+        slope_[i] = max(slope_[i], max(slope0_[i], slope1_[i]));
 #if DEBUG 
     cout << "time_shift_ = " << time_shift_ << ", toggle = " << toggle_ << endl;
     for (int r = 0; r < N_RANK; ++r) {
-        printf("slope[%d] = %d, ", r, slope_[r]);
+        printf("slope[%d] = %d (%d, %d), ", r, slope_[r], slope0_[r], slope1_[r]);
     }
     printf("\n");
 #endif
     regShapeFlag = true;
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n, Domain const & r_o, Domain const & r_p) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n, Domain const & r_o, Domain const & r_p) {
     logic_grid_.x0[7] = r_i.first();
     logic_grid_.x1[7] = r_i.first() + r_i.size();
     logic_grid_.x0[6] = r_j.first();
@@ -236,10 +474,11 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_p.first();
     logic_grid_.x1[0] = r_p.first() + r_p.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n, Domain const & r_o) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n, Domain const & r_o) {
     logic_grid_.x0[6] = r_i.first();
     logic_grid_.x1[6] = r_i.first() + r_i.size();
     logic_grid_.x0[5] = r_j.first();
@@ -255,10 +494,11 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_o.first();
     logic_grid_.x1[0] = r_o.first() + r_o.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m, Domain const & r_n) {
     logic_grid_.x0[5] = r_i.first();
     logic_grid_.x1[5] = r_i.first() + r_i.size();
     logic_grid_.x0[4] = r_j.first();
@@ -272,10 +512,11 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_n.first();
     logic_grid_.x1[0] = r_n.first() + r_n.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l, Domain const & r_m) {
     logic_grid_.x0[4] = r_i.first();
     logic_grid_.x1[4] = r_i.first() + r_i.size();
     logic_grid_.x0[3] = r_j.first();
@@ -287,10 +528,11 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_m.first();
     logic_grid_.x1[0] = r_m.first() + r_m.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k, Domain const & r_l) {
     logic_grid_.x0[3] = r_i.first();
     logic_grid_.x1[3] = r_i.first() + r_i.size();
     logic_grid_.x0[2] = r_j.first();
@@ -300,10 +542,11 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_l.first();
     logic_grid_.x1[0] = r_l.first() + r_l.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j, Domain const & r_k) {
     logic_grid_.x0[2] = r_i.first();
     logic_grid_.x1[2] = r_i.first() + r_i.size();
     logic_grid_.x0[1] = r_j.first();
@@ -311,39 +554,44 @@ void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j, Do
     logic_grid_.x0[0] = r_k.first();
     logic_grid_.x1[0] = r_k.first() + r_k.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i, Domain const & r_j) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i, Domain const & r_j) {
     logic_grid_.x0[1] = r_i.first();
     logic_grid_.x1[1] = r_i.first() + r_i.size();
     logic_grid_.x0[0] = r_j.first();
     logic_grid_.x1[0] = r_j.first() + r_j.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
-template <int N_RANK> template <typename Domain>
-void Pochoir<N_RANK>::Register_Domain(Domain const & r_i) {
+template <int N_RANK, int TOGGLE> template <typename Domain>
+void Pochoir<N_RANK, TOGGLE>::Register_Domain(Domain const & r_i) {
     logic_grid_.x0[0] = r_i.first();
     logic_grid_.x1[0] = r_i.first() + r_i.size();
     regLogicDomainFlag = true;
+    algor_.reset();
 }
 
 /* Executable Spec */
-template <int N_RANK> template <typename BF>
-void Pochoir<N_RANK>::Run(int timestep, BF const & bf) {
+template <int N_RANK, int TOGGLE> template <typename BF>
+void Pochoir<N_RANK, TOGGLE>::Run(int timestep, BF const & bf) {
     /* this version uses 'f' to compute interior region, 
      * and 'bf' to compute boundary region
      */
-    Algorithm<N_RANK> algor(slope_);
+    Algorithm<N_RANK> algor(slope_, slope0_, slope1_);
     algor.set_phys_grid(phys_grid_);
-    algor.set_thres(arr_type_size_);
+    algor.set_thres(arr_type_size_, cell_bytes_);
     timestep_ = timestep;
     /* base_case_kernel() will mimic exact the behavior of serial nested loop!
     */
     checkFlags();
     inRun = true;
-    algor.base_case_kernel_boundary(0 + time_shift_, timestep + time_shift_, logic_grid_, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) {
+        algor.base_case_kernel_boundary(t0, t1, grid, bf);
+    });
     inRun = false;
     // algor.sim_bicut_zero(0 + time_shift_, timestep + time_shift_, logic_grid_, bf);
     /* obase_boundary_p() is a parallel divide-and-conquer algorithm, which checks
@@ -353,48 +601,71 @@ void Pochoir<N_RANK>::Run(int timestep, BF const & bf) {
 }
 
 /* safe/non-safe ExecSpec */
-template <int N_RANK> template <typename F, typename BF>
-void Pochoir<N_RANK>::Run(int timestep, F const & f, BF const & bf) {
-    Algorithm<N_RANK> algor(slope_);
-    algor.set_phys_grid(phys_grid_);
-    algor.set_thres(arr_type_size_);
+template <int N_RANK, int TOGGLE> template <typename F, typename BF>
+void Pochoir<N_RANK, TOGGLE>::Run(int timestep, F const & f, BF const & bf) {
     /* this version uses 'f' to compute interior region, 
      * and 'bf' to compute boundary region
      */
     timestep_ = timestep;
     checkFlags();
+    Algorithm<N_RANK> & algor = algorithm("spec_p", true, timestep, [&]() { Run(timestep, f, bf); });
+    if (walk_ == POCHOIR_WALK_DIAMOND) {
+        auto l_f = [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.base_case_kernel_interior(t0, t1, grid, f); };
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.diamond_tile_p(t0, t1, grid, l_f, bf); });
+        return;
+    }
+#if POCHOIR_NUMA && BICUT
+    /* the node slabs are cut out of the whole grid, not of flat slabs */
+    int l_n[N_RANK];
+    if (pochoir_numa_nodes() > 1 && algor.flat_slabs(logic_grid_, l_n) == 1) {
+        auto l_g = [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.walk_bicut_boundary_p(t0, t1, grid, f, bf); };
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.numa_slab_cut(t0, t1, grid, true, l_g); });
+        return;
+    }
+#endif
 #pragma isat marker M2_begin
 #if BICUT
 #if 1
-    algor.walk_bicut_boundary_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.walk_bicut_boundary_p(t0, t1, grid, f, bf); });
 #else
-    algor.sim_bicut_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.sim_bicut_p(t0, t1, grid, f, bf); });
 #endif
 #else
-    algor.walk_ncores_boundary_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.walk_ncores_boundary_p(t0, t1, grid, f, bf); });
 #endif
 #pragma isat marker M2_end
 }
 
 /* obase for zero-padded area! */
-template <int N_RANK> template <typename F>
-void Pochoir<N_RANK>::Run_Obase(int timestep, F const & f) {
-    Algorithm<N_RANK> algor(slope_);
-    algor.set_phys_grid(phys_grid_);
-    algor.set_thres(arr_type_size_);
+template <int N_RANK, int TOGGLE> template <typename F>
+void Pochoir<N_RANK, TOGGLE>::Run_Obase(int timestep, F const & f) {
     timestep_ = timestep;
     checkFlags();
+    Algorithm<N_RANK> & algor = algorithm("obase", false, timestep, [&]() { Run_Obase(timestep, f); });
+    if (walk_ == POCHOIR_WALK_DIAMOND) {
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.diamond_tile(t0, t1, grid, f); });
+        return;
+    }
+#if POCHOIR_NUMA && BICUT
+    /* the node slabs are cut out of the whole grid, not of flat slabs */
+    int l_n[N_RANK];
+    if (pochoir_numa_nodes() > 1 && algor.flat_slabs(logic_grid_, l_n) == 1) {
+        auto l_g = [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.shorter_duo_sim_obase_bicut(t0, t1, grid, f); };
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.numa_slab_cut(t0, t1, grid, false, l_g); });
+        return;
+    }
+#endif
 #if BICUT
 #if 0
     fprintf(stderr, "Call obase_bicut\n");
 #pragma isat marker M2_begin
-    algor.obase_bicut(0+time_shift_, timestep+time_shift_, logic_grid_, f);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.obase_bicut(t0, t1, grid, f); });
 #pragma isat marker M2_end
 #else
 //     fprintf(stderr, "Call shorter_duo_sim_obase_bicut\n");
 #pragma isat marker M2_begin
    // algor.sim_obase_bicut(0+time_shift_, timestep+time_shift_, logic_grid_, f);
-    algor.shorter_duo_sim_obase_bicut(0+time_shift_, timestep+time_shift_, logic_grid_, f);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.shorter_duo_sim_obase_bicut(t0, t1, grid, f); });
     // algor.duo_sim_obase_bicut(0+time_shift_, timestep+time_shift_, logic_grid_, f);
 #pragma isat marker M2_end
 #if STAT
@@ -404,33 +675,44 @@ void Pochoir<N_RANK>::Run_Obase(int timestep, F const & f) {
 #endif
 #endif
 #else
-    algor.obase_m(0+time_shift_, timestep+time_shift_, logic_grid_, f);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.obase_m(t0, t1, grid, f); });
 #endif
 }
 
 /* obase for interior and ExecSpec for boundary */
-template <int N_RANK> template <typename F, typename BF>
-void Pochoir<N_RANK>::Run_Obase(int timestep, F const & f, BF const & bf) {
+template <int N_RANK, int TOGGLE> template <typename F, typename BF>
+void Pochoir<N_RANK, TOGGLE>::Run_Obase(int timestep, F const & f, BF const & bf) {
     int l_total_points = 1;
-    Algorithm<N_RANK> algor(slope_);
-    algor.set_phys_grid(phys_grid_);
-    algor.set_thres(arr_type_size_);
     /* this version uses 'f' to compute interior region, 
      * and 'bf' to compute boundary region
      */
     timestep_ = timestep;
     checkFlags();
+    Algorithm<N_RANK> & algor = algorithm("obase_p", true, timestep, [&]() { Run_Obase(timestep, f, bf); });
+    if (walk_ == POCHOIR_WALK_DIAMOND) {
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.diamond_tile_p(t0, t1, grid, f, bf); });
+        return;
+    }
+#if POCHOIR_NUMA && BICUT
+    /* the node slabs are cut out of the whole grid, not of flat slabs */
+    int l_n[N_RANK];
+    if (pochoir_numa_nodes() > 1 && algor.flat_slabs(logic_grid_, l_n) == 1) {
+        auto l_g = [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.shorter_duo_sim_obase_bicut_p(t0, t1, grid, f, bf); };
+        walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.numa_slab_cut(t0, t1, grid, true, l_g); });
+        return;
+    }
+#endif
 #if BICUT
 #if 0
     fprintf(stderr, "Call obase_bicut_boundary_P\n");
 #pragma isat marker M2_begin
-    algor.obase_bicut_boundary_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.obase_bicut_boundary_p(t0, t1, grid, f, bf); });
 #pragma isat marker M2_end
 #else
 //    fprintf(stderr, "Call sim_obase_bicut_P\n");
 #pragma isat marker M2_begin
     // algor.sim_obase_bicut_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
-    algor.shorter_duo_sim_obase_bicut_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.shorter_duo_sim_obase_bicut_p(t0, t1, grid, f, bf); });
 #pragma isat marker M2_end
 #if STAT
     for (int i = 1; i < SUPPORT_RANK; ++i) {
@@ -440,9 +722,228 @@ void Pochoir<N_RANK>::Run_Obase(int timestep, F const & f, BF const & bf) {
 #endif
 #else
 #pragma isat marker M2_begin
-    algor.obase_boundary_p(0+time_shift_, timestep+time_shift_, logic_grid_, f, bf);
+    walk(algor, timestep, [&](int t0, int t1, grid_info<N_RANK> const & grid) { algor.obase_boundary_p(t0, t1, grid, f, bf); });
 #pragma isat marker M2_end
 #endif
 }
 
+template <int N_RANK, int TOGGLE>
+std::string Pochoir<N_RANK, TOGGLE>::tune_key(char const * walker) {
+    std::ostringstream l_key;
+    /* FNV-1a over the shape */
+    unsigned int l_hash = 2166136261u;
+    for (int i = 0; i < shape_size_; ++i) {
+        for (int r = 0; r < N_RANK+1; ++r) {
+            l_hash = (l_hash ^ (unsigned int)shape_[i].shift[r]) * 16777619u;
+        }
+    }
+    /* the diamond tiles read the same thresholds, with other optima */
+    l_key << (walk_ == POCHOIR_WALK_DIAMOND ? "diamond_" : "") << walker << "/r" << N_RANK << "/s" << cell_bytes_ << "/g";
+    for (int i = N_RANK-1; i >= 0; --i) {
+        l_key << (logic_grid_.x1[i] - logic_grid_.x0[i]) << (i > 0 ? "x" : "");
+    }
+    l_key << "/p" << pochoir_get_nworkers() << "/" << std::hex << l_hash;
+    return l_key.str();
+}
+
+/* the default thresholds of Algorithm::set_thres(), unless the tuning 
+ * database has some for this problem; 'run' reruns the caller, for
+ * tuning on the spot with POCHOIR_TUNE=1; 'boundary' tells whether the
+ * walker has boundary thresholds to tune as well
+ */
+template <int N_RANK, int TOGGLE> template <typename Fn>
+void Pochoir<N_RANK, TOGGLE>::set_thres(Algorithm<N_RANK> & algor, char const * walker, bool boundary, int timestep, Fn const & run) {
+    if (tuning_) {
+        algor.set_thres(thres_);
+        return;
+    }
+    algor.set_thres(arr_type_size_, cell_bytes_);
+    std::string l_key = tune_key(walker);
+    if (l_key != tuneKey_) {
+        tuneKey_ = l_key;
+        tuneFound_ = pochoir_tune_load(tuneKey_, thres_);
+        if (!tuneFound_ && pochoir_tune_env())
+            tune(walker, boundary, timestep, run);
+    }
+    if (tuneFound_)
+        algor.set_thres(thres_);
+}
+
+/* the walker of the Runs with 'walker', set up by the first of them */
+template <int N_RANK, int TOGGLE> template <typename Fn>
+Algorithm<N_RANK> & Pochoir<N_RANK, TOGGLE>::algorithm(char const * walker, bool boundary, int timestep, Fn const & run) {
+    if (algor_.get() == NULL || algorWalker_ == NULL || strcmp(algorWalker_, walker) != 0) {
+        algor_.reset(new Algorithm<N_RANK>(slope_, slope0_, slope1_));
+        algor_->set_phys_grid(phys_grid_);
+        /* before set_thres(), whose tuner reruns the caller */
+        algorWalker_ = walker;
+        set_thres(*algor_, walker, boundary, timestep, run);
+    } else if (tuning_) {
+        algor_->set_thres(thres_);
+    }
+    return *algor_;
+}
+
+/* the height of the bands of POCHOIR_END_BAND : that of the highest zoid
+ * which all walkers cut in space right away
+ */
+template <int N_RANK, int TOGGLE>
+int Pochoir<N_RANK, TOGGLE>::band_height(void) {
+    int l_band = 1;
+    for (int i = 0; i < N_RANK; ++i) {
+        if (slope_[i] > 0)
+            l_band = max(l_band, (logic_grid_.x1[i] - logic_grid_.x0[i]) / (2 * slope_[i]));
+    }
+    return l_band;
+}
+
+/* walk 'timestep' steps on from time_ : w(t0, t1, grid) walks [t0, t1) 
+ * of the time-shifted steps over a slab of Algorithm::flat_cut()
+ */
+template <int N_RANK, int TOGGLE> template <typename W>
+void Pochoir<N_RANK, TOGGLE>::walk(Algorithm<N_RANK> & algor, int timestep, W const & w) {
+    int l_end = time_ + timestep;
+    if (runEnd_ == POCHOIR_END_BAND) {
+        int const l_band = band_height();
+        l_end = (l_end + l_band - 1) / l_band * l_band;
+        pochoir_run([&]() {
+            for (int t = time_; t < l_end; t = (t / l_band + 1) * l_band)
+                algor.flat_cut(t + time_shift_, min((t / l_band + 1) * l_band, l_end) + time_shift_, logic_grid_, w);
+        });
+    } else {
+        pochoir_run([&]() { algor.flat_cut(time_ + time_shift_, l_end + time_shift_, logic_grid_, w); });
+    }
+    time_ = l_end;
+}
+
+template <int N_RANK, int TOGGLE> template <typename R, typename W>
+Pochoir_Async Pochoir<N_RANK, TOGGLE>::Run_Async(int timestep, int every, R const & run, W const & watermark) {
+    int const l_end = time_ + timestep;
+    Pochoir_Async l_async;
+    if (every <= 0)
+        every = timestep;
+    checkFlags();
+    l_async.start([=]() {
+        if (time_ >= l_end)
+            return -1;
+        run(min(every, l_end - time_));
+        return time_;
+    }, [this](int t) {
+        pochoir_run([&]() {
+            for (size_t i = 0; i < snapshot_.size(); ++i)
+                snapshot_[i](t);
+        });
+    }, watermark, !snapshot_.empty());
+    return l_async;
+}
+
+/* a coordinate search from the default thresholds : each threshold in 
+ * turn is doubled (or halved) as long as that makes 'run' faster by 
+ * more than the noise, until a whole pass brings nothing
+ */
+template <int N_RANK, int TOGGLE> template <typename Fn>
+void Pochoir<N_RANK, TOGGLE>::tune(char const * walker, bool boundary, int timestep, Fn const & run) {
+    /* dt, dx[N_RANK-1..0], then the same for the boundary, which the 
+     * diamond tiles have none of 
+     */
+    if (walk_ == POCHOIR_WALK_DIAMOND)
+        boundary = false;
+    int const l_nparam = (boundary ? 2 : 1) * (N_RANK + 1);
+    int const l_max_pass = 3;
+    Algorithm<N_RANK> algor(slope_, slope0_, slope1_);
+    struct timeval l_start, l_end;
+    thres_info<N_RANK> l_best;
+    double l_best_time;
+    /* every candidate runs the same steps, on the same contents of the 
+     * arrays, and so does the Run the tuner may have been called from
+     */
+    int const l_time0 = time_;
+    std::vector<std::function<void ()> > l_restore;
+    std::set<void const *> l_done;
+    for (size_t i = 0; i < backup_.size(); ++i)
+        l_restore.push_back(backup_[i](l_done));
+    auto l_reset = [&]() {
+        time_ = l_time0;
+        for (size_t i = 0; i < l_restore.size(); ++i)
+            l_restore[i]();
+    };
+
+    algor.set_thres(arr_type_size_, cell_bytes_);
+    algor.get_thres(l_best);
+    tuneKey_ = tune_key(walker);
+    tuning_ = true;
+    thres_ = l_best;
+    gettimeofday(&l_start, 0);
+    run();
+    gettimeofday(&l_end, 0);
+    l_reset();
+    l_best_time = tdiff(&l_end, &l_start);
+    for (int l_pass = 0; l_pass < l_max_pass; ++l_pass) {
+        bool l_improved = false;
+        for (int p = 0; p < l_nparam; ++p) {
+            int const l_dim = p % (N_RANK + 1);
+            for (int l_dir = 0; l_dir < 2; ++l_dir) {
+                bool l_better = true;
+                while (l_better) {
+                    thres_ = l_best;
+                    int & l_val = (p <= N_RANK) 
+                        ? (l_dim == 0 ? thres_.dt : thres_.dx[N_RANK - l_dim]) 
+                        : (l_dim == 0 ? thres_.dt_boundary : thres_.dx_boundary[N_RANK - l_dim]);
+                    /* past the height/width of the grid, nothing changes */
+                    int const l_max = (l_dim == 0) ? timestep : (logic_grid_.x1[N_RANK - l_dim] - logic_grid_.x0[N_RANK - l_dim]);
+                    int const l_old = l_val;
+                    l_val = (l_dir == 0) ? 2 * l_old : l_old / 2;
+                    if (l_val < 1 || l_val == l_old || (l_dir == 0 && l_old >= l_max))
+                        break;
+                    gettimeofday(&l_start, 0);
+                    run();
+                    gettimeofday(&l_end, 0);
+                    l_reset();
+                    double const l_time = tdiff(&l_end, &l_start);
+                    l_better = (l_time < 0.97 * l_best_time);
+                    if (l_better) {
+                        l_best = thres_;
+                        l_best_time = l_time;
+                        l_improved = true;
+                    }
+                }
+            }
+        }
+        if (!l_improved)
+            break;
+    }
+    tuning_ = false;
+    thres_ = l_best;
+    tuneFound_ = true;
+    /* the kept walker has the last candidate, the next Run sets it up 
+     * again, with l_best
+     */
+    algorWalker_ = NULL;
+    pochoir_tune_store(tuneKey_, thres_);
+    printf("Pochoir tuning: %s : dt = %d, dt_boundary = %d", tuneKey_.c_str(), thres_.dt, thres_.dt_boundary);
+    for (int i = N_RANK-1; i >= 0; --i)
+        printf(", dx[%d] = %d", i, thres_.dx[i]);
+    for (int i = N_RANK-1; i >= 0; --i)
+        printf(", dx_boundary[%d] = %d", i, thres_.dx_boundary[i]);
+    printf(" (%g ms)\n", 1.0e3 * l_best_time);
+}
+
+template <int N_RANK, int TOGGLE> template <typename F, typename BF>
+void Pochoir<N_RANK, TOGGLE>::Tune(int timestep, F const & f, BF const & bf) {
+    checkFlags();
+    tune("spec_p", true, timestep, [&]() { Run(timestep, f, bf); });
+}
+
+template <int N_RANK, int TOGGLE> template <typename F>
+void Pochoir<N_RANK, TOGGLE>::Tune_Obase(int timestep, F const & f) {
+    checkFlags();
+    tune("obase", false, timestep, [&]() { Run_Obase(timestep, f); });
+}
+
+template <int N_RANK, int TOGGLE> template <typename F, typename BF>
+void Pochoir<N_RANK, TOGGLE>::Tune_Obase(int timestep, F const & f, BF const & bf) {
+    checkFlags();
+    tune("obase_p", true, timestep, [&]() { Run_Obase(timestep, f, bf); });
+}
+
 #endif
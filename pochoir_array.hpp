@@ -28,6 +28,16 @@
 #include <iomanip>
 #include <cstdio>
 #include <cstdlib>
+#include <new>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <set>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 #include "pochoir_range.hpp"
 #include "pochoir_common.hpp"
@@ -36,12 +46,12 @@
 using namespace std;
 
 template <int DIM>
-inline int cal_index(int const * _idx, int const * _stride) {
+inline T_index cal_index(int const * _idx, T_index const * _stride) {
 	return (_idx[DIM] * _stride[DIM]) + cal_index<DIM-1>(_idx, _stride);
 }
 
 template <>
-inline int cal_index<0>(int const * _idx, int const * _stride) {
+inline T_index cal_index<0>(int const * _idx, T_index const * _stride) {
 	/* 0-dim is always the time dimension */
 	return (_idx[0] * _stride[0]);
 }
@@ -51,18 +61,219 @@ class Storage {
 	private:
 		T * storage_;
 		int ref_;
+		T_index size_;
+        Pochoir_Alloc_Type alloc_type_;
+        /* number of slabs along the highest spatial dimension, and the size
+         * of each slab within one time plane
+         */
+        int slab_num_, toggle_;
+        T_index slab_size_, plane_size_;
+        /* file descriptor backing a POCHOIR_ALLOC_MMAP storage */
+        int fd_;
+        /* bytes of an anonymous hugetlbfs mapping (0 if from malloc), and 
+         * the page size we think backs the storage
+         */
+        size_t map_bytes_, page_bytes_;
+
+        /* touch the slabs [_slab_lb, _slab_ub) of all time planes, bisected
+         * the same way as the first space cuts of the walkers, so that
+         * each page lands on the node of the worker computing on it
+         */
+        void first_touch(int _slab_lb, int _slab_ub, int _grain) {
+            if (_slab_ub - _slab_lb > _grain) {
+                pochoir_task_frame;
+                int l_slab_mid = _slab_lb + (_slab_ub - _slab_lb) / 2;
+                pochoir_spawn(first_touch(_slab_lb, l_slab_mid, _grain));
+                first_touch(l_slab_mid, _slab_ub, _grain);
+                pochoir_sync;
+                return;
+            }
+            for (int t = 0; t < toggle_; ++t) {
+                T_index l_start = t * plane_size_ + _slab_lb * slab_size_;
+                /* the last slab also covers the padding at the end of a plane */
+                T_index l_end = t * plane_size_ + (_slab_ub == slab_num_ ? plane_size_ : _slab_ub * slab_size_);
+                for (T_index i = l_start; i < l_end; ++i)
+                    new (storage_ + i) T();
+            }
+        }
+        /* every time plane starts on a POCHOIR_ALIGN boundary as long as
+         * the plane size is a multiple of the alignment
+         * - huge pages are tried from hugetlbfs first, then as transparent
+         *   huge pages on a 2MB aligned chunk, then we fall back to small
+         *   pages; none of them touches the pages, the initializer does
+         */
+        inline void aligned_alloc_mem(Pochoir_Page_Type _page) {
+            size_t l_bytes = size_ * sizeof(T);
+            map_bytes_ = 0;
+            page_bytes_ = sysconf(_SC_PAGESIZE);
+            if (_page != POCHOIR_PAGE_SMALL) {
+                size_t const l_2M = 1UL << 21;
+#if defined(MAP_HUGETLB)
+                int l_shift = (_page == POCHOIR_PAGE_HUGE_1G) ? 30 : 21;
+                size_t l_huge = 1UL << l_shift;
+                size_t l_map_bytes = (l_bytes + l_huge - 1) / l_huge * l_huge;
+                int l_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_HUGE_SHIFT)
+                l_flags |= l_shift << MAP_HUGE_SHIFT;
+#endif
+                /* without MAP_NORESERVE, mmap() fails right away if the
+                 * reserved pool is too small, instead of a SIGBUS later on
+                 */
+                void * l_ptr = mmap(NULL, l_map_bytes, PROT_READ | PROT_WRITE, l_flags, -1, 0);
+                if (l_ptr != MAP_FAILED) {
+                    storage_ = (T *) l_ptr;
+                    map_bytes_ = l_map_bytes;
+                    page_bytes_ = l_huge;
+                    return;
+                }
+#endif
+#if defined(MADV_HUGEPAGE)
+                size_t l_thp_bytes = (l_bytes + l_2M - 1) / l_2M * l_2M;
+                if (posix_memalign((void **)&storage_, l_2M, l_thp_bytes) == 0) {
+                    if (madvise(storage_, l_thp_bytes, MADV_HUGEPAGE) == 0)
+                        page_bytes_ = l_2M;
+                    return;
+                }
+#endif
+            }
+            if (posix_memalign((void **)&storage_, POCHOIR_ALIGN, l_bytes) != 0) {
+                printf("Pochoir memory allocation error:\n");
+                printf("Failed to allocate %ld elements!\n", (long)size_);
+                exit(1);
+            }
+        }
 	public:
-		inline Storage(int _sz) {
-			storage_ = new T[_sz];
+		inline Storage(T_index _sz, Pochoir_Page_Type _page = POCHOIR_PAGE_SMALL) {
+            size_ = _sz;
+            aligned_alloc_mem(_page);
+			ref_ = 1;
+            alloc_type_ = POCHOIR_ALLOC_SERIAL;
+			for (T_index i = 0; i < _sz; ++i)
+				new (storage_ + i) T();
+		}
+
+        /* parallel first-touch version
+         * - _toggle time planes, each of _plane_size elements
+         * - each plane consists of _slab_num slabs of _slab_size elements
+         *   along the highest spatial dimension
+         */
+		inline Storage(int _toggle, T_index _plane_size, int _slab_num, T_index _slab_size, Pochoir_Page_Type _page = POCHOIR_PAGE_SMALL) {
+            size_ = _toggle * _plane_size;
+            /* allocation doesn't touch the pages of a big chunk,
+             * the first write in first_touch() does, which also prefaults
+             * huge pages on the node of the worker computing on them
+             */
+            aligned_alloc_mem(_page);
 			ref_ = 1;
-			for (int i = 0; i < _sz; ++i)
-				storage_[i] = T();
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            toggle_ = _toggle; plane_size_ = _plane_size;
+            slab_num_ = _slab_num; slab_size_ = _slab_size;
+            /* no point to split a single (huge) page among workers */
+            int l_grain = max(1, (int)(page_bytes_ / (slab_size_ * sizeof(T))));
+#if POCHOIR_NUMA
+            /* the slabs of each node of the walkers (numa_slab_cut) */
+            int l_nodes = pochoir_numa_nodes();
+            pochoir_run([&]() { 
+                pochoir_on_nodes([&](int n) {
+                    first_touch(pochoir_numa_slab(n, l_nodes, slab_num_), pochoir_numa_slab(n+1, l_nodes, slab_num_), l_grain);
+                });
+            });
+#else
+            pochoir_run([&]() { first_touch(0, slab_num_, l_grain); });
+#endif
 		}
 
+        /* file-backed version : the _sz elements live in a shared mapping
+         * of the file _fname
+         * - a file of exactly the right size is mapped as it is, which is 
+         *   how a run restarts from the toggle buffer of a previous run
+         * - otherwise the file is cut to nothing first and then resized, so
+         *   a stale file of another size reads back as zeros, and T has
+         *   to be a type whose all-zero bytes are a valid value; we don't 
+         *   construct the elements, which would touch every page of a 
+         *   buffer that might not fit into memory
+         */
+        inline Storage(char const * _fname, T_index _sz, Pochoir_Mmap_Advice _advice) {
+            size_ = _sz;
+            ref_ = 1;
+            alloc_type_ = POCHOIR_ALLOC_MMAP;
+            map_bytes_ = 0;
+            page_bytes_ = sysconf(_SC_PAGESIZE);
+            off_t l_bytes = (off_t)size_ * sizeof(T);
+            struct stat l_stat;
+            fd_ = open(_fname, O_RDWR | O_CREAT, 0644);
+            if (fd_ < 0 || fstat(fd_, &l_stat) != 0) {
+                printf("Pochoir memory allocation error:\n");
+                printf("Failed to open the backing file %s!\n", _fname);
+                exit(1);
+            }
+            bool l_restart = (l_stat.st_size == l_bytes);
+            if (!l_restart && (ftruncate(fd_, 0) != 0 || ftruncate(fd_, l_bytes) != 0)) {
+                printf("Pochoir memory allocation error:\n");
+                printf("Failed to resize the backing file %s to %ld bytes!\n", _fname, (long)l_bytes);
+                exit(1);
+            }
+            storage_ = (T *) mmap(NULL, l_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (storage_ == (T *) MAP_FAILED) {
+                printf("Pochoir memory allocation error:\n");
+                printf("Failed to map the backing file %s!\n", _fname);
+                exit(1);
+            }
+            if (_advice == POCHOIR_MADV_AUTO) {
+                double l_phys_mem = (double) sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+                if (l_bytes <= 0.5 * l_phys_mem)
+                    _advice = l_restart ? POCHOIR_MADV_WILLNEED : POCHOIR_MADV_NORMAL;
+                else
+                    _advice = POCHOIR_MADV_RANDOM;
+            }
+            int l_advice = MADV_NORMAL;
+            switch (_advice) {
+                case POCHOIR_MADV_SEQUENTIAL : l_advice = MADV_SEQUENTIAL; break;
+                case POCHOIR_MADV_RANDOM : l_advice = MADV_RANDOM; break;
+                case POCHOIR_MADV_WILLNEED : l_advice = MADV_WILLNEED; break;
+                default : l_advice = MADV_NORMAL; break;
+            }
+            /* only a hint, so it's fine if the kernel ignores it */
+            madvise(storage_, l_bytes, l_advice);
+        }
+
+        /* wrap the application's buffer _ptr of _sz elements, which are 
+         * already constructed and stay the application's to free
+         */
+        inline Storage(T * _ptr, T_index _sz) {
+            storage_ = _ptr;
+            size_ = _sz;
+            ref_ = 1;
+            alloc_type_ = POCHOIR_ALLOC_USER;
+            map_bytes_ = 0;
+            page_bytes_ = sysconf(_SC_PAGESIZE);
+        }
+
 		inline ~Storage() {
-			delete[] storage_;
+            if (alloc_type_ == POCHOIR_ALLOC_USER)
+                return;
+            if (alloc_type_ == POCHOIR_ALLOC_MMAP) {
+                /* the elements stay in the file for the next run */
+                munmap(storage_, size_ * sizeof(T));
+                close(fd_);
+                return;
+            }
+            for (T_index i = 0; i < size_; ++i)
+                storage_[i].~T();
+            if (map_bytes_ > 0)
+                munmap(storage_, map_bytes_);
+            else
+                free(storage_);
 		}
 
+        /* write the dirty pages of a file-backed storage back to the file,
+         * e.g. as a checkpoint between two Run()s
+         */
+        inline void sync() {
+            if (alloc_type_ == POCHOIR_ALLOC_MMAP)
+                msync(storage_, size_ * sizeof(T), MS_SYNC);
+        }
+
 		inline void inc_ref() { 
 			++ref_; 
 		}
@@ -75,18 +286,256 @@ class Storage {
 			return ref_; 
 		}
 
-		inline T & operator[] (int _idx) {
+		inline T & operator[] (T_index _idx) {
 			return storage_[_idx];
 		}
 
-		inline T const & operator[] (int _idx) const {
+		inline T const & operator[] (T_index _idx) const {
 			return storage_[_idx];
 		}
 
 		T * data() { return storage_; }
+		T_index size() const { return size_; }
+
+        /* report how much of the resident storage is backed by huge pages,
+         * summed over the mappings in /proc/self/smaps which the storage 
+         * overlaps (a mapping may be shared with neighboring allocations)
+         */
+        void print_huge_pages(void) {
+#if defined(__linux__)
+            unsigned long l_begin = (unsigned long)storage_;
+            unsigned long l_end = (unsigned long)(storage_ + size_);
+            unsigned long l_vma_begin, l_vma_end;
+            long l_value, l_rss = 0, l_huge = 0;
+            bool l_overlap = false;
+            char l_line[256], l_key[64];
+            FILE * l_smaps = fopen("/proc/self/smaps", "r");
+            if (l_smaps == NULL) {
+                printf("Pochoir huge pages : /proc/self/smaps not available!\n");
+                return;
+            }
+            while (fgets(l_line, sizeof(l_line), l_smaps) != NULL) {
+                if (sscanf(l_line, "%lx-%lx ", &l_vma_begin, &l_vma_end) == 2) {
+                    l_overlap = (l_vma_begin < l_end && l_vma_end > l_begin);
+                } else if (l_overlap && sscanf(l_line, "%63s %ld", l_key, &l_value) == 2) {
+                    std::string l_field(l_key);
+                    if (l_field == "Rss:")
+                        l_rss += l_value;
+                    else if (l_field == "AnonHugePages:")
+                        l_huge += l_value;
+                    else if (l_field == "Private_Hugetlb:" || l_field == "Shared_Hugetlb:") {
+                        /* hugetlbfs pages don't show up in Rss */
+                        l_rss += l_value;
+                        l_huge += l_value;
+                    }
+                }
+            }
+            fclose(l_smaps);
+            printf("Pochoir huge pages : %ld kB of %ld kB resident (%.1f%%), page size %ld kB\n", 
+                   l_huge, l_rss, (l_rss > 0) ? 100.0 * l_huge / l_rss : 0.0, (long)(page_bytes_ >> 10));
+#else
+            printf("Pochoir huge pages : not supported on this platform!\n");
+#endif
+        }
+
+        /* debug dump : how many pages of the storage reside on each NUMA node */
+        void print_numa_pages(void) {
+#if defined(__linux__) && defined(SYS_move_pages)
+            long l_page_size = sysconf(_SC_PAGESIZE);
+            unsigned long l_begin = (unsigned long)storage_ & ~(l_page_size - 1);
+            unsigned long l_end = (unsigned long)(storage_ + size_);
+            long l_num_pages = (l_end - l_begin + l_page_size - 1) / l_page_size;
+            void ** l_pages = (void **) malloc(l_num_pages * sizeof(void *));
+            int * l_status = (int *) malloc(l_num_pages * sizeof(int));
+            long l_node_pages[MAX_NUMA_NODE], l_unknown_pages = 0;
+
+            for (int i = 0; i < MAX_NUMA_NODE; ++i)
+                l_node_pages[i] = 0;
+            for (long i = 0; i < l_num_pages; ++i)
+                l_pages[i] = (void *)(l_begin + i * l_page_size);
+            /* move_pages() with NULL nodes only queries the placement */
+            if (syscall(SYS_move_pages, 0, l_num_pages, l_pages, NULL, l_status, 0) != 0) {
+                printf("Pochoir NUMA placement : move_pages() not supported!\n");
+            } else {
+                for (long i = 0; i < l_num_pages; ++i) {
+                    if (l_status[i] >= 0 && l_status[i] < MAX_NUMA_NODE)
+                        ++l_node_pages[l_status[i]];
+                    else
+                        ++l_unknown_pages;
+                }
+                printf("Pochoir NUMA placement : %ld pages\n", l_num_pages);
+                for (int i = 0; i < MAX_NUMA_NODE; ++i) {
+                    if (l_node_pages[i] > 0)
+                        printf("node %d : %ld pages\n", i, l_node_pages[i]);
+                }
+                if (l_unknown_pages > 0)
+                    printf("not present : %ld pages\n", l_unknown_pages);
+            }
+            free(l_pages);
+            free(l_status);
+#else
+            printf("Pochoir NUMA placement : not supported on this platform!\n");
+#endif
+        }
+};
+
+/* type of the boundary value function pointer of a rank N_RANK array */
+template <typename T_Array, typename T, int N_RANK>
+struct Pochoir_BValue_Ptr;
+
+/* a Pochoir_Const_Array of rank N has no time index, so its boundary
+ * value function is the one of rank N-1, down to this one for N = 1
+ */
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 0> { typedef T (*type)(T_Array &, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 1> { typedef T (*type)(T_Array &, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 2> { typedef T (*type)(T_Array &, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 3> { typedef T (*type)(T_Array &, int, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 4> { typedef T (*type)(T_Array &, int, int, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 5> { typedef T (*type)(T_Array &, int, int, int, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 6> { typedef T (*type)(T_Array &, int, int, int, int, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 7> { typedef T (*type)(T_Array &, int, int, int, int, int, int, int, int); };
+template <typename T_Array, typename T>
+struct Pochoir_BValue_Ptr<T_Array, T, 8> { typedef T (*type)(T_Array &, int, int, int, int, int, int, int, int, int); };
+
+/* call a boundary function _bf with the index array _idx[] of orig_value(),
+ * whose _idx[0] is the lowest spatial dimension
+ */
+template <int N_RANK>
+struct Pochoir_BValue_Call;
+
+template <>
+struct Pochoir_BValue_Call<1> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<2> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<3> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[2], _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<4> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[3], _idx[2], _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<5> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<6> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<7> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[6], _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]); }
+};
+template <>
+struct Pochoir_BValue_Call<8> {
+    template <typename BF, typename T_Array>
+    static inline typename T_Array::value_type call(BF const & _bf, T_Array & _arr, int _t, int const * _idx) { return _bf(_arr, _t, _idx[7], _idx[6], _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]); }
+};
+
+/* boundary value function of a Pochoir_Array, selected by its BF parameter :
+ * - Pochoir_BValue_Fn (default) : a function pointer registered at run time,
+ *   e.g. Register_Boundary(heat_bv_2D), called indirectly
+ * - any other type is a functor or lambda type, whose copy is registered by
+ *   Register_Boundary(); the call is direct, so the compiler inlines it 
+ *   into the boundary clone, e.g.
+ *      Pochoir_Array<double, 2, 2, heat_bv_2D_fn> a(N, N);
+ *      a.Register_Boundary(heat_bv_2D_fn());
+ *   where heat_bv_2D_fn comes with Pochoir_Boundary_2D(heat_bv_2D, ...)
+ */
+struct Pochoir_BValue_Fn { };
+
+template <typename T_Array, typename T, int N_RANK, typename BF>
+class Pochoir_BValue {
+    private:
+        BF * bf_;
+    public:
+        typedef BF const & arg_type;
+        Pochoir_BValue() : bf_(NULL) { }
+        Pochoir_BValue(Pochoir_BValue const & orig) : bf_(orig.bf_ == NULL ? NULL : new BF(*orig.bf_)) { }
+        Pochoir_BValue & operator= (Pochoir_BValue const & orig) {
+            if (this != &orig) {
+                reset();
+                bf_ = (orig.bf_ == NULL ? NULL : new BF(*orig.bf_));
+            }
+            return *this;
+        }
+        ~Pochoir_BValue() { reset(); }
+        void set(arg_type _bf) { reset(); bf_ = new BF(_bf); }
+        void reset(void) { delete bf_; bf_ = NULL; }
+        POCHOIR_FORCE_INLINE bool registered(void) const { return bf_ != NULL; }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return (*bf_)(_arr, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        /* _idx[] in the order of size_info */
+        inline T value(T_Array & _arr, int _t, int const * _idx) const { return Pochoir_BValue_Call<N_RANK>::call(*bf_, _arr, _t, _idx); }
+};
+
+template <typename T_Array, typename T, int N_RANK>
+class Pochoir_BValue<T_Array, T, N_RANK, Pochoir_BValue_Fn> {
+    private:
+        typedef typename Pochoir_BValue_Ptr<T_Array, T, N_RANK>::type BValue;
+        BValue bv_;
+    public:
+        typedef BValue arg_type;
+        Pochoir_BValue() : bv_(NULL) { }
+        void set(arg_type _bv) { bv_ = _bv; }
+        void reset(void) { bv_ = NULL; }
+        POCHOIR_FORCE_INLINE bool registered(void) const { return bv_ != NULL; }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx1, int _idx0) const { return bv_(_arr, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        POCHOIR_FORCE_INLINE T operator() (T_Array & _arr, int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const { return bv_(_arr, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0); }
+        inline T value(T_Array & _arr, int _t, int const * _idx) const { return Pochoir_BValue_Call<N_RANK>::call(bv_, _arr, _t, _idx); }
 };
 
-template <typename T, int N_RANK>
+/* the home of one boundary value, which the non-const Pochoir_Array::operator()
+ * takes as its defaulted last argument : the default argument is made in the
+ * caller's full expression and lives until its end, and so does the
+ * reference operator() hands out for an off-domain read, however many of
+ * them the expression has. The value is left uninitialized until it is set.
+ */
+template <typename T>
+struct Pochoir_BValue_Slot {
+    T value_;
+    POCHOIR_FORCE_INLINE Pochoir_BValue_Slot() { }
+};
+
+/* TOGGLE is the number of time planes kept in the toggle buffer, which has to
+ * be the time depth of the registered shape plus one, 
+ * BF is the type of the boundary function (see Pochoir_BValue above),
+ * LAYOUT the memory layout of a time plane (see Pochoir_Layout_Type), known
+ * at compile time so that a row-major array indexes with the strides only
+ */
+template <typename T, int N_RANK, int TOGGLE = 2, typename BF = Pochoir_BValue_Fn, Pochoir_Layout_Type LAYOUT = POCHOIR_DEFAULT_LAYOUT>
 class Pochoir_Array {
 	private:
 		Storage<T> * view_; // real storage of elements
@@ -95,30 +544,41 @@ class Pochoir_Array {
 		size_info logic_size_; // logical of elements in each dimension
 		size_info logic_start_, logic_end_; 
 		size_info phys_size_; // physical of elements in each dimension
-		size_info stride_; // stride of each dimension
+		T_index stride_[N_RANK]; // stride of each dimension
         bool allocMemFlag_;
-		int total_size_;
+        Pochoir_Alloc_Type alloc_type_;
+        std::string mmap_file_;
+        Pochoir_Mmap_Advice mmap_advice_;
+        Pochoir_Page_Type page_type_;
+        /* offset of each index of dimensions 1 .. N_RANK-1 within a time 
+         * plane, see init_layout_offset()
+         */
+        std::vector<T_index> off_tab_[N_RANK];
+        T_index const * off_[N_RANK];
+		T_index total_size_;
+        /* the writer plane, see take_snapshot() */
+        std::vector<T> snap_;
         int slope_[N_RANK], toggle_;
+        /* offset of each time plane, for non-power-of-two TOGGLE */
+        T_index toggle_offset_[TOGGLE];
         Pochoir_Shape<N_RANK> * shape_;
         int shape_size_;
-        typedef T (*BValue_1D)(Pochoir_Array<T, 1> &, int, int);
-        typedef T (*BValue_2D)(Pochoir_Array<T, 2> &, int, int, int);
-        typedef T (*BValue_3D)(Pochoir_Array<T, 3> &, int, int, int, int);
-        typedef T (*BValue_4D)(Pochoir_Array<T, 4> &, int, int, int, int, int);
-        typedef T (*BValue_5D)(Pochoir_Array<T, 5> &, int, int, int, int, int, int);
-        typedef T (*BValue_6D)(Pochoir_Array<T, 6> &, int, int, int, int, int, int, int);
-        typedef T (*BValue_7D)(Pochoir_Array<T, 7> &, int, int, int, int, int, int, int, int);
-        typedef T (*BValue_8D)(Pochoir_Array<T, 8> &, int, int, int, int, int, int, int, int, int);
         T * l_null;
-        BValue_1D bv1_;
-        BValue_2D bv2_;
-        BValue_3D bv3_;
-        BValue_4D bv4_;
-        BValue_5D bv5_;
-        BValue_6D bv6_;
-        BValue_7D bv7_;
-        BValue_8D bv8_;
+        typedef Pochoir_BValue<Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT>, T, N_RANK, BF> bvalue_type;
+        bvalue_type bv_;
+        /* let go of the storage, the last one to hold it deletes it */
+        static void drop_storage(Storage<T> * _view) {
+            _view->dec_ref();
+            if (_view->ref() == 0)
+                delete _view;
+        }
+        void drop_view(void) {
+            if (view_ != NULL)
+                drop_storage(view_);
+            view_ = NULL;
+        }
 	public:
+        typedef T value_type;
 		/* create array with initial size 
          * - Following dimensions for constructors are spatial dimension
          * - all spatial dimensions are row-majored
@@ -129,9 +589,11 @@ class Pochoir_Array {
             stride_[0] = 1; 
             total_size_ = sz0;
             view_ = NULL;
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //            view_ = new Storage<T>(TOGGLE * total_size_);
 //            data_ = view_->data();
         }
@@ -142,11 +604,13 @@ class Pochoir_Array {
             logic_start_[0] = 0; logic_end_[0] = sz0;
             logic_start_[1] = 0; logic_end_[1] = sz1;
 			stride_[1] = sz0; stride_[0] = 1; 
-			total_size_ = phys_size_[0] * phys_size_[1];
+			total_size_ = (T_index)phys_size_[0] * phys_size_[1];
 			view_ = NULL;
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE * total_size_) ;
 //            data_ = view_->data();
 		}
@@ -165,9 +629,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //  		  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -187,9 +653,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -210,9 +678,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -234,9 +704,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -259,9 +731,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -285,9 +759,11 @@ class Pochoir_Array {
 			}
 			view_ = NULL;
 			/* double the total_size_ because we are using toggle array */
-            bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL;
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
 //			  view_ = new Storage<T>(TOGGLE*total_size_) ;
 //            data_ = view_->data();
 		}
@@ -295,60 +771,63 @@ class Pochoir_Array {
 		/* Copy constructor -- create another view of the
 		 * same array
 		 */
-		Pochoir_Array (Pochoir_Array<T, N_RANK> const & orig) {
+		Pochoir_Array (Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> const & orig) {
 			total_size_ = orig.total_size();
 			for (int i = 0; i < N_RANK; ++i) {
 				phys_size_[i] = orig.phys_size(i);
 				logic_size_[i] = orig.logic_size(i);
-				stride_[i] = orig.stride(i);
+				stride_[i] = orig.stride_[i];
                 logic_start_[i] = 0; logic_end_[i] = logic_size_[i];
 			}
+            init_layout_offset();
 			view_ = NULL;
-			view_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).view();
+			view_ = const_cast<Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> &>(orig).view();
 			view_->inc_ref();
-            /* We also get the BValue function pointer from orig */
-            bv1_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_1D(); 
-            bv2_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_2D(); 
-            bv3_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_3D(); 
-            bv4_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_4D(); 
-            bv5_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_5D(); 
-            bv6_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_6D(); 
-            bv7_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_7D(); 
-            bv8_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_8D(); 
-            data_ = view_->data();
+            /* We also get the boundary function from orig */
+            bv_ = orig.bv_;
+            data_ = orig.data_;
+            set_toggle_offset();
             l_null = (T*) calloc(1, sizeof(T));
             allocMemFlag_ = true;
+            alloc_type_ = orig.alloc_type_;
+            mmap_file_ = orig.mmap_file_;
+            mmap_advice_ = orig.mmap_advice_;
+            page_type_ = orig.page_type_;
 		}
 
         /* assignment operator for vector<> */
-		Pochoir_Array<T, N_RANK> & operator= (Pochoir_Array<T, N_RANK> const & orig) {
+		Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> & operator= (Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> const & orig) {
+            if (this == &orig)
+                return *this;
 			total_size_ = orig.total_size();
 			for (int i = 0; i < N_RANK; ++i) {
 				phys_size_[i] = orig.phys_size(i);
 				logic_size_[i] = orig.logic_size(i);
-				stride_[i] = orig.stride(i);
+				stride_[i] = orig.stride_[i];
 			}
-			view_ = NULL;
-			view_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).view();
-			view_->inc_ref();
-            /* We also get the BValue function pointer from orig */
-            bv1_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_1D(); 
-            bv2_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_2D(); 
-            bv3_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_3D(); 
-            bv4_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_4D(); 
-            bv5_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_5D(); 
-            bv6_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_6D(); 
-            bv7_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_7D(); 
-            bv8_ = const_cast<Pochoir_Array<T, N_RANK> &>(orig).bv_8D(); 
-            data_ = view_->data();
-            l_null = (T*) calloc(1, sizeof(T));
+            init_layout_offset();
+            /* take the new view before letting go of the old one, 
+             * which may be the last reference to it
+             */
+            Storage<T> * l_view = const_cast<Pochoir_Array<T, N_RANK, TOGGLE, BF, LAYOUT> &>(orig).view();
+			l_view->inc_ref();
+            drop_view();
+			view_ = l_view;
+            /* We also get the boundary function from orig */
+            bv_ = orig.bv_;
+            data_ = orig.data_;
+            set_toggle_offset();
             allocMemFlag_ = true;
+            alloc_type_ = orig.alloc_type_;
+            mmap_file_ = orig.mmap_file_;
+            mmap_advice_ = orig.mmap_advice_;
+            page_type_ = orig.page_type_;
             return *this;
 		}
 
 		/* destructor : free memory */
 		~Pochoir_Array() {
-			view_->dec_ref();
+            drop_view();
             allocMemFlag_ = false;
             free(l_null);
 		}
@@ -358,27 +837,15 @@ class Pochoir_Array {
 		}
 
         inline T * data() { return data_; }
-        /* return the function pointer which generates the boundary value! */
-        BValue_1D bv_1D(void) { return bv1_; }
-        BValue_2D bv_2D(void) { return bv2_; }
-        BValue_3D bv_3D(void) { return bv3_; }
-        BValue_4D bv_4D(void) { return bv4_; }
-        BValue_5D bv_5D(void) { return bv5_; }
-        BValue_6D bv_6D(void) { return bv6_; }
-        BValue_7D bv_7D(void) { return bv7_; }
-        BValue_8D bv_8D(void) { return bv8_; }
-
-        /* guarantee that only one version of boundary function is registered ! */
-        void Register_Boundary(BValue_1D _bv1) { bv1_ = _bv1;  bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_2D _bv2) { bv2_ = _bv2;  bv1_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_3D _bv3) { bv3_ = _bv3;  bv1_ = NULL; bv2_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_4D _bv4) { bv4_ = _bv4;  bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_5D _bv5) { bv5_ = _bv5;  bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_6D _bv6) { bv6_ = _bv6;  bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv7_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_7D _bv7) { bv7_ = _bv7;  bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv8_ = NULL;}
-        void Register_Boundary(BValue_8D _bv8) { bv8_ = _bv8;  bv1_ = NULL; bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL;}
-
-        void unRegister_Boundary(void) { bv1_ = NULL;  bv2_ = NULL; bv3_ = NULL; bv4_ = NULL; ; bv5_ = NULL; bv6_ = NULL; bv7_ = NULL; bv8_ = NULL}
+        /* return the boundary function */
+        bvalue_type const & bv(void) const { return bv_; }
+
+        /* a function pointer (Pochoir_Boundary_ND) for the default BF,
+         * or an object of the functor/lambda type BF otherwise
+         */
+        void Register_Boundary(typename bvalue_type::arg_type _bv) { bv_.set(_bv); }
+
+        void unRegister_Boundary(void) { bv_.reset(); }
 
         void Register_Domain(grid_info<N_RANK> initial_grid) {
             for (int i = 0; i < N_RANK; ++i) {
@@ -407,6 +874,11 @@ class Pochoir_Array {
             }
             depth = l_max_time_shift - l_min_time_shift;
             toggle_ = depth + 1;
+            if (toggle_ != TOGGLE) {
+                printf("Pochoir array toggle error:\n");
+                printf("The shape has a time depth of %d, which needs a Pochoir_Array with toggle %d instead of %d!\n", depth, toggle_, TOGGLE);
+                exit(1);
+            }
             for (int i = 0; i < shape_size; ++i) {
                 for (int r = 1; r < N_RANK+1; ++r) {
                     slope_[N_RANK-r] = max(slope_[N_RANK-r], abs((int)ceil((float)shape[i].shift[r]/(l_max_time_shift - shape[i].shift[0]))));
@@ -445,6 +917,11 @@ class Pochoir_Array {
             }
             depth = l_max_time_shift - l_min_time_shift;
             toggle_ = depth + 1;
+            if (toggle_ != TOGGLE) {
+                printf("Pochoir array toggle error:\n");
+                printf("The shape has a time depth of %d, which needs a Pochoir_Array with toggle %d instead of %d!\n", depth, toggle_, TOGGLE);
+                exit(1);
+            }
             for (int i = 0; i < N_SIZE; ++i) {
                 for (int r = 1; r < N_RANK+1; ++r) {
                     slope_[N_RANK-r] = max(slope_[N_RANK-r], abs((int)ceil((float)shape[i].shift[r]/(l_max_time_shift - shape[i].shift[0]))));
@@ -520,13 +997,322 @@ class Pochoir_Array {
                 slope_[i] = _slope[i]; 
         }
         void set_toggle(int _toggle) { toggle_ = _toggle; }
+        void set_toggle_offset(void) {
+            for (int i = 0; i < TOGGLE; ++i)
+                toggle_offset_[i] = i * total_size_;
+        }
+        /* offset of the time plane of time step _t in the toggle buffer,
+         * TOGGLE is known at compile time, so a power-of-two TOGGLE
+         * turns into a mask, and any other TOGGLE into a constant modulo
+         * (no division instruction) plus a table lookup
+         */
+        inline T_index time_offset(int _t) const {
+            return ((TOGGLE & (TOGGLE - 1)) == 0) ? (_t & (TOGGLE - 1)) * total_size_ : toggle_offset_[_t % TOGGLE];
+        }
+        /* has to be called before the array is registered with a Pochoir
+         * object, which is where the memory gets allocated
+         */
+        void set_alloc_type(Pochoir_Alloc_Type _alloc_type) { alloc_type_ = _alloc_type; }
+        /* put the toggle buffer into a shared mapping of file _fname,
+         * which is re-used as it is if it has the right size, so a
+         * restart gets the array back with the same shape and layout
+         */
+        void set_mmap_file(char const * _fname, Pochoir_Mmap_Advice _advice = POCHOIR_MADV_AUTO) {
+            alloc_type_ = POCHOIR_ALLOC_MMAP;
+            mmap_file_ = _fname;
+            mmap_advice_ = _advice;
+        }
+        /* use the application's buffer _buf as the toggle buffer, without
+         * a copy :
+         * - _stride[i] is the stride of dimension i, in elements, ordered 
+         *   the same as stride(); dimension 0 has to be contiguous, which 
+         *   is what the generated kernels walk along. NULL means packed 
+         *   row-major
+         * - _plane is the distance between two time planes, time step t 
+         *   lives in plane t % TOGGLE starting at _buf + (t % TOGGLE) * _plane,
+         *   0 means the planes are packed back to back
+         * The array can be accessed right away, and adopt() can be called 
+         * again between two Run()s to switch to another buffer. _buf stays
+         * the application's, Pochoir never frees it.
+         */
+        void adopt(T * _buf, T_index const * _stride = NULL, T_index _plane = 0) {
+            if (LAYOUT >= POCHOIR_LAYOUT_BRICK) {
+                printf("Pochoir array adopt error:\n");
+                printf("Only a row-major Pochoir array can adopt a buffer!\n");
+                exit(1);
+            }
+            stride_[0] = 1;
+            for (int i = 1; i < N_RANK; ++i)
+                stride_[i] = (_stride != NULL) ? _stride[i] : stride_[i-1] * phys_size_[i-1];
+            T_index l_extent = 1;
+            for (int i = 0; i < N_RANK; ++i)
+                l_extent += stride_[i] * (phys_size_[i] - 1);
+            total_size_ = (_plane > 0) ? _plane : l_extent;
+            if ((_stride != NULL && _stride[0] != 1) || total_size_ < l_extent) {
+                printf("Pochoir array adopt error:\n");
+                printf("The buffer needs a unit stride along dimension 0 and time planes of at least %ld elements apart!\n", (long)l_extent);
+                exit(1);
+            }
+            drop_view();
+            view_ = new Storage<T>(_buf, TOGGLE * total_size_);
+            alloc_type_ = POCHOIR_ALLOC_USER;
+            init_layout_offset();
+            set_toggle_offset();
+            data_ = view_->data();
+            allocMemFlag_ = true;
+        }
+        /* hand the time plane of time step _t (e.g. the last one of a Run())
+         * back to the application without a copy, laid out with the strides
+         * of stride(). The returned pointer shares the ownership of the 
+         * whole toggle buffer with the array (and its copies), so it stays
+         * valid after the array is gone, and the buffer is freed the way it
+         * was allocated when the last of them goes; for an adopted buffer 
+         * it points into the application's buffer anyway. A file-backed
+         * array is unmapped with its storage, sync() is the way to get its
+         * planes out.
+         */
+        std::shared_ptr<T> release(int _t) {
+            if (!allocMemFlag_ || LAYOUT >= POCHOIR_LAYOUT_BRICK || alloc_type_ == POCHOIR_ALLOC_MMAP) {
+                printf("Pochoir array release error:\n");
+                printf("Only an allocated row-major Pochoir array, not backed by a file, can hand out its time planes!\n");
+                exit(1);
+            }
+            view_->inc_ref();
+            std::shared_ptr<Storage<T> > l_owner(view_, drop_storage);
+            return std::shared_ptr<T>(l_owner, data_ + time_offset(_t));
+        }
+        void set_page_type(Pochoir_Page_Type _page_type) { page_type_ = _page_type; }
+        /* recompute stride_[] and total_size_ for the padded layout :
+         * - each row (dimension 0) starts on a POCHOIR_ALIGN boundary
+         * - a stride which is a multiple of POCHOIR_CONFLICT_SIZE maps 
+         *   neighboring rows/planes onto the same cache sets, so we add one
+         *   more cache line to it
+         * - each time plane is a whole number of cache lines
+         * Both operator() and the generated pointer code go through
+         * stride_[] and total_size_, so they don't see any difference
+         */
+        void pad_layout(void) {
+            /* we can't align rows of elements which don't tile a cache line */
+            if (POCHOIR_ALIGN % sizeof(T) != 0)
+                return;
+            int const l_line = POCHOIR_ALIGN / sizeof(T);
+            stride_[0] = 1;
+            for (int i = 0; i < N_RANK-1; ++i) {
+                T_index l_stride = stride_[i] * phys_size_[i];
+                l_stride = (l_stride + l_line - 1) / l_line * l_line;
+                if ((l_stride * sizeof(T)) % POCHOIR_CONFLICT_SIZE == 0)
+                    l_stride += l_line;
+                stride_[i+1] = l_stride;
+            }
+            total_size_ = stride_[N_RANK-1] * phys_size_[N_RANK-1];
+            total_size_ = (total_size_ + l_line - 1) / l_line * l_line;
+        }
+        /* fill off_[] for the current layout, and for the bricked layouts
+         * also set total_size_ :
+         * - a row (dimension 0) is padded to whole cache lines if the 
+         *   elements tile them
+         * - a brick is POCHOIR_BRICK^(N_RANK-1) rows, the bricks of a time
+         *   plane are row-major, with partial bricks at the upper ends
+         * - index x of dimension i goes to brick x / POCHOIR_BRICK, and to row
+         *   (x % POCHOIR_BRICK) * POCHOIR_BRICK^(i-1) of it, or for Morton 
+         *   order to the row we get by moving bit b of x % POCHOIR_BRICK to
+         *   bit b * (N_RANK-1) + i-1
+         * Either way the offset is a sum of one term per dimension, so a
+         * table lookup per dimension is all an access needs. The tables 
+         * cover one array size off either side, which is more than any 
+         * slope, and a bricked array wraps such an index around to keep it
+         * inside the buffer.
+         */
+        void init_layout_offset(void) {
+            bool const l_brick = (LAYOUT >= POCHOIR_LAYOUT_BRICK);
+            T_index l_row = phys_size_[0];
+            if (l_brick && POCHOIR_ALIGN % sizeof(T) == 0) {
+                int const l_line = POCHOIR_ALIGN / sizeof(T);
+                l_row = (l_row + l_line - 1) / l_line * l_line;
+            }
+            T_index l_brick_stride = l_row;
+            for (int i = 1; i < N_RANK; ++i)
+                l_brick_stride *= POCHOIR_BRICK;
+            for (int i = 1; i < N_RANK; ++i) {
+                int const l_size = phys_size_[i];
+                off_tab_[i].resize(3 * (T_index)l_size);
+                for (int x = -l_size; x < 2 * l_size; ++x) {
+                    int const l_x = (x + l_size) % l_size;
+                    int const l_r = l_x & (POCHOIR_BRICK - 1);
+                    T_index l_intra = 0;
+                    if (LAYOUT == POCHOIR_LAYOUT_MORTON) {
+                        for (int b = 0; (1 << b) < POCHOIR_BRICK; ++b) {
+                            if (l_r & (1 << b))
+                                l_intra |= (T_index)1 << (b * (N_RANK-1) + i-1);
+                        }
+                    } else {
+                        l_intra = l_r;
+                        for (int j = 1; j < i; ++j)
+                            l_intra *= POCHOIR_BRICK;
+                    }
+                    off_tab_[i][x + l_size] = (l_brick) ? (l_x / POCHOIR_BRICK) * l_brick_stride + l_intra * l_row : x * stride_[i];
+                }
+                off_[i] = &off_tab_[i][l_size];
+                l_brick_stride *= (l_size + POCHOIR_BRICK - 1) / POCHOIR_BRICK;
+            }
+            if (l_brick && N_RANK > 1) {
+                total_size_ = l_brick_stride;
+            }
+        }
+        /* offset of index _x of dimension _dim (>= 1) within a time plane */
+        inline T_index dim_offset(int _dim, int _x) const {
+            return (LAYOUT >= POCHOIR_LAYOUT_BRICK) ? off_[_dim][_x] : _x * stride_[_dim];
+        }
+        /* the table of dim_offset() of dimension _dim (>= 1), which the 
+         * generated -split-opt-pointer code uses to get to the start of
+         * each row, whatever the layout
+         */
+        T_index const * layout_offset(int _dim) const { return off_[_dim]; }
+        /* take a copy of the whole toggle buffer, and return what puts it
+         * back, e.g. around the trial runs of Pochoir::tune()
+         * - a storage already in _done (shared by a group, see group()) 
+         *   is copied only once
+         * - a file-backed storage may not fit into memory, so it is copied
+         *   to an unlinked scratch file next to its backing file
+         */
+        std::function<void ()> backup(std::set<void const *> & _done) {
+            if (!allocMemFlag_ || !_done.insert(view_).second)
+                return [](){};
+            Storage<T> * l_view = view_;
+            size_t const l_size = l_view->size();
+            if (alloc_type_ == POCHOIR_ALLOC_MMAP) {
+                std::string const l_name = mmap_file_ + ".backup";
+                FILE * l_f = fopen(l_name.c_str(), "w+b");
+                if (l_f == NULL || fwrite(l_view->data(), sizeof(T), l_size, l_f) != l_size) {
+                    printf("Pochoir memory allocation error:\n");
+                    printf("Failed to copy the backing file %s to %s!\n", mmap_file_.c_str(), l_name.c_str());
+                    exit(1);
+                }
+                remove(l_name.c_str());
+                std::shared_ptr<FILE> l_file(l_f, fclose);
+                return [l_view, l_size, l_file]() { 
+                    rewind(l_file.get());
+                    if (fread(l_view->data(), sizeof(T), l_size, l_file.get()) != l_size) {
+                        printf("Pochoir memory allocation error:\n");
+                        printf("Failed to read back the copy of a backing file!\n");
+                        exit(1);
+                    }
+                };
+            }
+            std::shared_ptr<std::vector<T> > l_copy(new std::vector<T>(l_view->data(), l_view->data() + l_size));
+            return [l_view, l_copy]() { std::copy(l_copy->begin(), l_copy->end(), l_view->data()); };
+        }
+        /* copy time plane _t into the writer plane (Pochoir::Register_Snapshot()),
+         * where snap(i, j, ..) reads it with the spatial indices of interior()
+         * while the following time steps overwrite the toggle buffer.
+         * The plane of a member of a group (group()) interleaves the elements
+         * of all members, stride_[0] apart, only the ones of this array are 
+         * copied, so the writer plane is stride_[0] times smaller.
+         */
+        void take_snapshot(int _t) {
+            T const * l_src = data_ + time_offset(_t);
+            T_index const l_step = stride_[0];
+            T_index const l_size = total_size_ / l_step;
+            T_index const l_chunk = 1 << 16;
+            snap_.resize(l_size);
+            pochoir_for (k, 0, (int)((l_size + l_chunk - 1) / l_chunk)) {
+                T_index const l_lb = k * l_chunk;
+                T_index const l_ub = min(l_lb + l_chunk, l_size);
+                if (l_step == 1) {
+                    std::copy(l_src + l_lb, l_src + l_ub, &snap_[l_lb]);
+                } else {
+                    for (T_index l = l_lb; l < l_ub; ++l)
+                        snap_[l] = l_src[l * l_step];
+                }
+            } pochoir_for_end;
+        }
+        template <typename ... I>
+        inline T snap(I ... _idx) const {
+            static_assert(sizeof...(I) == N_RANK, "snap() takes one index per spatial dimension");
+            int const l_idx[] = { _idx ... };
+            T_index l_off = l_idx[N_RANK-1] * stride_[0];
+            for (int i = 1; i < N_RANK; ++i)
+                l_off += dim_offset(i, l_idx[N_RANK-1-i]);
+            return snap_[l_off / stride_[0]];
+        }
         void alloc_mem(void) {
             if (!allocMemFlag_) {
-                view_ = new Storage<T>(toggle_*total_size_) ;
+                if (LAYOUT == POCHOIR_LAYOUT_PADDED) {
+                    pad_layout();
+                }
+                init_layout_offset();
+                view_ = new_storage();
+                set_toggle_offset();
                 data_ = view_->data();
                 allocMemFlag_ = true;
             }
         }
+        /* a toggle buffer for the current total_size_ and alloc_type_ */
+        Storage<T> * new_storage(void) {
+            Storage<T> * l_view;
+            if (alloc_type_ == POCHOIR_ALLOC_FIRST_TOUCH) {
+                /* slabs along the highest spatial dimension, which is 
+                 * the one the walkers cut first, a bricked array has 
+                 * one slab per layer of bricks
+                 */
+                int l_slab_num = phys_size_[N_RANK-1];
+                if (LAYOUT >= POCHOIR_LAYOUT_BRICK && N_RANK > 1)
+                    l_slab_num = (l_slab_num + POCHOIR_BRICK - 1) / POCHOIR_BRICK;
+                l_view = new Storage<T>(TOGGLE, total_size_, l_slab_num, total_size_ / l_slab_num, page_type_);
+            } else if (alloc_type_ == POCHOIR_ALLOC_MMAP) {
+                l_view = new Storage<T>(mmap_file_.c_str(), TOGGLE*total_size_, mmap_advice_);
+            } else {
+                l_view = new Storage<T>(TOGGLE*total_size_, page_type_) ;
+            }
+            if (page_type_ != POCHOIR_PAGE_SMALL && alloc_type_ != POCHOIR_ALLOC_MMAP)
+                l_view->print_huge_pages();
+#if DEBUG
+            l_view->print_numa_pages();
+#endif
+            return l_view;
+        }
+        /* interleave the elements of this array with those of _n-1 other 
+         * arrays of the same element type and sizes, grid point by grid 
+         * point, as member _k of the group :
+         * - all strides and the plane size are _n times the ones of the 
+         *   array on its own, and data() starts at element _k of the 
+         *   shared toggle buffer, so the indexing and the generated code 
+         *   don't change
+         * - member 0 passes _view == NULL and allocates the buffer (with its
+         *   own alloc/page type), the others pass what it returns
+         * Pochoir::Register_Array_Group() is the way to call it. A group 
+         * can be grouped again (e.g. registered with another Pochoir 
+         * object), but an array which already has storage of its own can't.
+         */
+        Storage<T> * group(Storage<T> * _view, int _k, int _n) {
+            if (allocMemFlag_ && (_view == NULL || _view == view_))
+                return view_;
+            if (allocMemFlag_ || LAYOUT >= POCHOIR_LAYOUT_BRICK || alloc_type_ == POCHOIR_ALLOC_USER) {
+                printf("Pochoir array group error:\n");
+                printf("Only a row-major Pochoir array without storage of its own can join a group!\n");
+                exit(1);
+            }
+            if (LAYOUT == POCHOIR_LAYOUT_PADDED) {
+                pad_layout();
+            }
+            for (int i = 0; i < N_RANK; ++i)
+                stride_[i] *= _n;
+            total_size_ *= _n;
+            init_layout_offset();
+            if (_view == NULL) {
+                view_ = new_storage();
+            } else {
+                view_ = _view;
+                view_->inc_ref();
+            }
+            set_toggle_offset();
+            data_ = view_->data() + _k;
+            allocMemFlag_ = true;
+            return view_;
+        }
+        void print_numa_pages(void) { view_->print_numa_pages(); }
+        void print_huge_pages(void) { view_->print_huge_pages(); }
+        void sync(void) { view_->sync(); }
 		/* return size */
 		int phys_size(int _dim) const { return phys_size_[_dim]; }
 		int logic_size(int _dim) const { return logic_size_[_dim]; }
@@ -534,10 +1320,26 @@ class Pochoir_Array {
 		int size(int _dim) const { return phys_size_[_dim]; }
 
 		/* return total_size_ */
-		int total_size() const { return total_size_; }
+		T_index total_size() const { return total_size_; }
 
 		/* return stride */
-		int stride (int _dim) const { return stride_[_dim]; }
+		T_index stride (int _dim) const { 
+            if (_dim > 0 && LAYOUT >= POCHOIR_LAYOUT_BRICK) {
+                printf("Pochoir array layout error:\n");
+                printf("A bricked Pochoir array has no stride along dimension %d, use layout_offset() (-split-opt-pointer) instead!\n", _dim);
+                exit(1);
+            }
+            return stride_[_dim]; 
+        }
+        /* the same, checked at compile time, which is what the generated 
+         * pointer kernels call
+         */
+        template <int DIM>
+		T_index stride (void) const { 
+            static_assert(DIM == 0 || LAYOUT < POCHOIR_LAYOUT_BRICK, 
+                          "A bricked Pochoir array has no stride along dimensions 1 and up, use layout_offset() (-split-opt-pointer) instead!");
+            return stride_[DIM]; 
+        }
 
         inline bool check_boundary(size_info const & _idx) const {
             bool touch_boundary = false;
@@ -605,44 +1407,21 @@ class Pochoir_Array {
          */
         inline T orig_value (int _timestep, size_info & _idx) {
             bool l_boundary = check_boundary(_idx);
-            bool set_boundary = false;
-            T l_bvalue = 0;
-            if (l_boundary && bv1_ != NULL) {
-                l_bvalue = bv1_(*this, _timestep, _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv2_ != NULL) {
-                l_bvalue = bv2_(*this, _timestep, _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv3_ != NULL) {
-                l_bvalue = bv3_(*this, _timestep, _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv4_ != NULL) {
-                l_bvalue = bv4_(*this, _timestep, _idx[3], _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv5_ != NULL) {
-                l_bvalue = bv5_(*this, _timestep, _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv6_ != NULL) {
-                l_bvalue = bv6_(*this, _timestep, _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv7_ != NULL) {
-                l_bvalue = bv7_(*this, _timestep, _idx[6], _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            } else if (l_boundary && bv8_ != NULL) {
-                l_bvalue = bv8_(*this, _timestep, _idx[7], _idx[6], _idx[5], _idx[4], _idx[3], _idx[2], _idx[1], _idx[0]);
-                set_boundary = true;
-            }
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_.value(*this, _timestep, _idx) : (*l_null);
 
             /* the highest dimension is time dimension! */
-            int l_idx = cal_index<N_RANK>(_idx, stride_) + (_timestep % toggle_) * total_size_;
-            return (set_boundary) ? l_bvalue : (*view_)[l_idx];
+            T_index l_idx = _idx[0] * stride_[0] + time_offset(_timestep);
+            for (int i = 1; i < N_RANK; ++i)
+                l_idx += dim_offset(i, _idx[i]);
+            return (set_boundary) ? l_bvalue : data_[l_idx];
         }
 
 		/* index operator() for the format of a(i, j, k) 
          * - The highest dimension is always time dimension
          * - this is the uninterior version
          */
-		inline T operator() (int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -668,13 +1447,13 @@ class Pochoir_Array {
             /* we have to guard the use of bv_ by conditional, 
              * otherwise it may lead to some segmentation fault!
              */
-            bool set_boundary = (l_boundary && bv1_ != NULL);
-            T l_bvalue = (set_boundary) ? bv1_(*this, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-            return (set_boundary ? (l_bvalue) : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+            return (set_boundary ? (l_bvalue) : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -698,13 +1477,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary2(_idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv2_ != NULL);
-            T l_bvalue = (set_boundary) ? bv2_(*this, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -729,13 +1508,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary3(_idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv3_ != NULL);
-            T l_bvalue = (set_boundary) ? bv3_(*this, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -760,13 +1539,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary4(_idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv4_ != NULL);
-            T l_bvalue = (set_boundary) ? bv4_(*this, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -792,13 +1571,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary5(_idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv5_ != NULL);
-            T l_bvalue = (set_boundary) ? bv5_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -824,13 +1603,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary6(_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv6_ != NULL);
-            T l_bvalue = (set_boundary) ? bv6_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -857,13 +1636,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary7(_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv7_ != NULL);
-            T l_bvalue = (set_boundary) ? bv7_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -890,13 +1669,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary8(_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv8_ != NULL);
-            T l_bvalue = (set_boundary) ? bv8_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -919,13 +1698,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary1(_idx1, _idx0);
-            bool set_boundary = (l_boundary && bv1_ != NULL);
-            T l_bvalue = (set_boundary) ? bv1_(*this, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -954,13 +1733,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary2(_idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv2_ != NULL);
-            T l_bvalue = (set_boundary) ? bv2_(*this, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -985,13 +1764,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary3(_idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv3_ != NULL);
-            T l_bvalue = (set_boundary) ? bv3_(*this, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -1016,13 +1795,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary4(_idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv4_ != NULL);
-            T l_bvalue = (set_boundary) ? bv4_(*this, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -1048,13 +1827,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary5(_idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv5_ != NULL);
-            T l_bvalue = (set_boundary) ? bv5_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -1080,13 +1859,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary6(_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv6_ != NULL);
-            T l_bvalue = (set_boundary) ? bv6_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -1113,13 +1892,13 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary7(_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv7_ != NULL);
-            T l_bvalue = (set_boundary) ? bv7_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
-		inline T & operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0, Pochoir_BValue_Slot<T> && _slot = Pochoir_BValue_Slot<T>()) {
             if (!allocMemFlag_) {
                 printf("Pochoir array access error:\n");
                 printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
@@ -1146,51 +1925,51 @@ class Pochoir_Array {
             }
 #endif
             bool l_boundary = check_boundary8(_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv8_ != NULL);
-            T l_bvalue = (set_boundary) ? bv8_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+            return (set_boundary ? (_slot.value_ = l_bvalue) : data_[l_idx]);
 		}
 
         /* set()/get() pair to set/get boundary value in user supplied bvalue function */
 		inline T & set (int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+			return data_[l_idx];
 		}
 
 		inline T & set (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8i % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx1, int _idx0) {
@@ -1199,8 +1978,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d)\n", _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx2, int _idx1, int _idx0) {
@@ -1209,8 +1988,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d)\n", _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1219,8 +1998,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d, %d)\n", _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1229,8 +2008,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d, %d, %d)\n", _idx4, _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1239,8 +2018,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d, %d, %d, %d)\n", _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1249,8 +2028,8 @@ class Pochoir_Array {
                 printf("Out-of-range accesss by boundary function at index (%d, %d, %d, %d, %d, %d, %d)\n", _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1259,8 +2038,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d, %d, %d, %d, %d, %d)\n", _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+			return data_[l_idx];
 		}
 
 		inline T get (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
@@ -1269,8 +2048,8 @@ class Pochoir_Array {
                 printf("Out-of-range access by boundary function at index (%d, %d, %d, %d, %d, %d, %d, %d, %d)\n", _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
                 exit(1);
             }
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+			return data_[l_idx];
 		}
 
 		/* index operator() for the format of a.interior(i, j, k) 
@@ -1278,214 +2057,214 @@ class Pochoir_Array {
          * - this is the interior (non-checking) version
          */
 		inline T interior (int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+			return data_[l_idx];
 		}
 
 		inline T interior (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5i % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+			return data_[l_idx];
 		}
 
 		inline T & interior (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-			return (*view_)[l_idx];
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+			return data_[l_idx];
 		}
 
-		inline T boundary (int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx1, int _idx0) const {
             bool l_boundary = check_boundary1(_idx1, _idx0);
             /* we have to guard the use of bv_ by conditional, 
              * otherwise it may lead to some segmentation fault!
              */
-            bool set_boundary = (l_boundary && bv1_ != NULL);
-            T l_bvalue = (set_boundary) ? bv1_(*this, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-            return (set_boundary ? (l_bvalue) : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+            return (set_boundary ? (l_bvalue) : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary2(_idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv2_ != NULL);
-            T l_bvalue = (set_boundary) ? bv2_(*this, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary3(_idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv3_ != NULL);
-            T l_bvalue = (set_boundary) ? bv3_(*this, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary4(_idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv4_ != NULL);
-            T l_bvalue = (set_boundary) ? bv4_(*this, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary5(_idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv5_ != NULL);
-            T l_bvalue = (set_boundary) ? bv5_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary6(_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv6_ != NULL);
-            T l_bvalue = (set_boundary) ? bv6_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary7(_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv7_ != NULL);
-            T l_bvalue = (set_boundary) ? bv7_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+		POCHOIR_FORCE_INLINE T  boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
             bool l_boundary = check_boundary8(_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv8_ != NULL);
-            T l_bvalue = (set_boundary) ? bv8_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx1, int _idx0) {
             bool l_boundary = check_boundary1(_idx1, _idx0);
-            bool set_boundary = (l_boundary && bv1_ != NULL);
-            T l_bvalue = (set_boundary) ? bv1_(*this, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + (_idx1 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + time_offset(_idx1);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary2(_idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv2_ != NULL);
-            T l_bvalue = (set_boundary) ? bv2_(*this, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + (_idx2 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + time_offset(_idx2);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary3(_idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv3_ != NULL);
-            T l_bvalue = (set_boundary) ? bv3_(*this, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + (_idx3 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + time_offset(_idx3);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary4(_idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv4_ != NULL);
-            T l_bvalue = (set_boundary) ? bv4_(*this, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + (_idx4 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + time_offset(_idx4);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary5(_idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv5_ != NULL);
-            T l_bvalue = (set_boundary) ? bv5_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + (_idx5 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + time_offset(_idx5);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary6(_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv6_ != NULL);
-            T l_bvalue = (set_boundary) ? bv6_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + (_idx6 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + time_offset(_idx6);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary7(_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv7_ != NULL);
-            T l_bvalue = (set_boundary) ? bv7_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + (_idx7 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + time_offset(_idx7);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
-		inline T & boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+		POCHOIR_FORCE_INLINE T & boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
             bool l_boundary = check_boundary8(_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0);
-            bool set_boundary = (l_boundary && bv8_ != NULL);
-            T l_bvalue = (set_boundary) ? bv8_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
-			int l_idx = _idx0 * stride_[0] + _idx1 * stride_[1] + _idx2 * stride_[2] + _idx3 * stride_[3] + _idx4 * stride_[4] + _idx5 * stride_[5] + _idx6 * stride_[6] + _idx7 * stride_[7] + (_idx8 % toggle_) * total_size_;
-            return (set_boundary ? l_bvalue : (*view_)[l_idx]);
+            bool set_boundary = (l_boundary && bv_.registered());
+            T l_bvalue = (set_boundary) ? bv_(const_cast<Pochoir_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : (*l_null);
+			T_index l_idx = _idx0 * stride_[0] + dim_offset(1, _idx1) + dim_offset(2, _idx2) + dim_offset(3, _idx3) + dim_offset(4, _idx4) + dim_offset(5, _idx5) + dim_offset(6, _idx6) + dim_offset(7, _idx7) + time_offset(_idx8);
+            return (set_boundary ? l_bvalue : data_[l_idx]);
 		}
 
 
@@ -1509,12 +2288,12 @@ class Pochoir_Array {
 			return whole_done;
 		}
 
-		template <typename T2, int N2>
-		friend std::ostream& operator<<(std::ostream& os, Pochoir_Array<T2, N2> const & x); 
+		template <typename T2, int N2, int TOGGLE2, typename BF2>
+		friend std::ostream& operator<<(std::ostream& os, Pochoir_Array<T2, N2, TOGGLE2, BF2> const & x); 
 };
 
-template<typename T2, int N2>
-std::ostream& operator<<(std::ostream& os, Pochoir_Array<T2, N2> const & x) { 
+template<typename T2, int N2, int TOGGLE2, typename BF2>
+std::ostream& operator<<(std::ostream& os, Pochoir_Array<T2, N2, TOGGLE2, BF2> const & x) { 
 	typedef int size_info[N2];
 	size_info l_index, l_head_index, l_tail_index;
 	bool done = false, line_break = false;
@@ -1531,10 +2310,10 @@ std::ostream& operator<<(std::ostream& os, Pochoir_Array<T2, N2> const & x) {
 
 	while (!done) {
 		T2 x0, x1;
-		x0 = const_cast<Pochoir_Array<T2, N2> &>(x).orig_value(0, l_index);
-		x1 = const_cast<Pochoir_Array<T2, N2> &>(x).orig_value(1, l_index);
+		x0 = const_cast<Pochoir_Array<T2, N2, TOGGLE2, BF2> &>(x).orig_value(0, l_index);
+		x1 = const_cast<Pochoir_Array<T2, N2, TOGGLE2, BF2> &>(x).orig_value(1, l_index);
 		os << std::setw(9) << x0 << " (" << x1 << ")" << " "; 
-		done = const_cast<Pochoir_Array<T2, N2> &>(x).update_index(l_index, line_break, l_head_index, l_tail_index);
+		done = const_cast<Pochoir_Array<T2, N2, TOGGLE2, BF2> &>(x).update_index(l_index, line_break, l_head_index, l_tail_index);
 		if (line_break) {
 			os << std::endl;
 			line_break = false;
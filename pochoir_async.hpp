@@ -0,0 +1,140 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ * 		                     Charles E. Leiserson <cel@mit.edu>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ *********************************************************************************
+ */
+
+#ifndef POCHOIR_ASYNC_H
+#define POCHOIR_ASYNC_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include "pochoir_common.hpp"
+
+/* The handle of Pochoir::Run_Async() : a runner thread walks the time 
+ * steps a chunk at a time, and after each chunk the time plane it ended 
+ * on is final, its watermark. With a writer plane (Register_Snapshot()),
+ * the runner copies that plane into it and goes on with the next chunk,
+ * while a writer thread passes the watermark to the callback; the copy 
+ * stays as it is until the callback returns, and the runner only waits 
+ * for the writer if the next chunk is done before that. Without one, the
+ * runner calls the callback itself, between two chunks, while the plane
+ * is still in the toggle buffer.
+ */
+class Pochoir_Async {
+    private:
+        struct state {
+            std::thread runner_, writer_;
+            std::mutex lock_;
+            std::condition_variable cond_;
+            /* the plane handed to the writer, -1 once it is done with it */
+            int posted_;
+            /* the last watermark the callback returned from */
+            int time_;
+            bool finished_;
+        };
+        std::unique_ptr<state> s_;
+
+    public:
+    Pochoir_Async() { }
+    Pochoir_Async(Pochoir_Async && orig) : s_(std::move(orig.s_)) { }
+    ~Pochoir_Async() { wait(); }
+
+    /* step() runs a chunk and returns the time step it ended on, or -1
+     * if there is none left; snap(t) fills in the writer planes, if 
+     * 'overlap'; watermark(t) is the callback
+     */
+    template <typename Step, typename Snap, typename W>
+    void start(Step step, Snap snap, W watermark, bool overlap) {
+        s_.reset(new state);
+        state & l_s = *s_;
+        l_s.posted_ = l_s.time_ = -1;
+        l_s.finished_ = false;
+        if (overlap) {
+            l_s.writer_ = std::thread([&l_s, watermark]() {
+                std::unique_lock<std::mutex> l_lock(l_s.lock_);
+                for (;;) {
+                    l_s.cond_.wait(l_lock, [&]() { return l_s.posted_ >= 0 || l_s.finished_; });
+                    if (l_s.posted_ < 0)
+                        break;
+                    int const t = l_s.posted_;
+                    l_lock.unlock();
+                    watermark(t);
+                    l_lock.lock();
+                    l_s.time_ = t;
+                    l_s.posted_ = -1;
+                    l_s.cond_.notify_all();
+                }
+            });
+        }
+        l_s.runner_ = std::thread([&l_s, step, snap, watermark, overlap]() {
+            int t;
+            while ((t = step()) >= 0) {
+                if (!overlap) {
+                    watermark(t);
+                    std::lock_guard<std::mutex> l_lock(l_s.lock_);
+                    l_s.time_ = t;
+                    continue;
+                }
+                std::unique_lock<std::mutex> l_lock(l_s.lock_);
+                l_s.cond_.wait(l_lock, [&]() { return l_s.posted_ < 0; });
+                l_lock.unlock();
+                snap(t);
+                l_lock.lock();
+                l_s.posted_ = t;
+                l_s.cond_.notify_all();
+            }
+            std::lock_guard<std::mutex> l_lock(l_s.lock_);
+            l_s.finished_ = true;
+            l_s.cond_.notify_all();
+        });
+    }
+
+    /* wait for the run and the last callback to finish */
+    void wait(void) {
+        if (s_.get() == NULL)
+            return;
+        if (s_->runner_.joinable())
+            s_->runner_.join();
+        if (s_->writer_.joinable())
+            s_->writer_.join();
+    }
+
+    bool done(void) {
+        if (s_.get() == NULL)
+            return true;
+        std::lock_guard<std::mutex> l_lock(s_->lock_);
+        return s_->finished_ && s_->posted_ < 0;
+    }
+
+    /* the last watermark the callback is done with, -1 if none yet */
+    int time(void) {
+        if (s_.get() == NULL)
+            return -1;
+        std::lock_guard<std::mutex> l_lock(s_->lock_);
+        return s_->time_;
+    }
+};
+
+#endif /* POCHOIR_ASYNC_H */
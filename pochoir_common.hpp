@@ -31,12 +31,14 @@
 #include <cmath>
 #include <cstdlib>
 #include <string>
+/* the stream headers, as the ones in pochoir_parallel.hpp, have to come
+ * before the max() / min() macros below
+ */
+#include <iostream>
+#include <iomanip>
+#include <sstream>
 
-#if 0
-#define cilk_spawn 
-#define cilk_sync
-#define cilk_for for
-#endif
+#include "pochoir_parallel.hpp"
 
 static inline double tdiff (struct timeval *a, struct timeval *b)
 {
@@ -49,6 +51,8 @@ static inline int StrToInt(const std::string& s)
 }
 
 #define ARRAY_LENGTH(x) (int)(sizeof(x)/sizeof(x[0]))
+/* for small accessors which the inliner would otherwise give up on */
+#define POCHOIR_FORCE_INLINE inline __attribute__((always_inline))
 
 /* due to the fact that bit trick is much slower than conditional instruction,
  * let's disable it for now!!!
@@ -80,8 +84,20 @@ static inline double select(bool b, double x, double y) {
     return *(double*)&__ir__;
 }
 
+/* T_index is the type of linearized offsets into the toggle buffer,
+ * toggle * total_size can easily go beyond 2^31 for big 3D grids.
+ * Coordinates of each single dimension (grid_info) still fit into int.
+ */
+#ifndef LONG_INDEX
+#define LONG_INDEX 1
+#endif
+
 typedef int T_dim;
+#if LONG_INDEX
+typedef long T_index;
+#else
 typedef int T_index;
+#endif
 
 template <int N_RANK>
 struct grid_info {
@@ -89,6 +105,16 @@ struct grid_info {
     int dx0[N_RANK], dx1[N_RANK];
 };
 
+/* recursion thresholds of the walkers : a zoid is cut in time while it is
+ * taller than dt, and in dimension i while it is wider than dx[i]; the
+ * _boundary ones are for zoids which touch the boundary
+ */
+template <int N_RANK>
+struct thres_info {
+    int dt, dt_boundary;
+    int dx[N_RANK], dx_boundary[N_RANK];
+};
+
 template <int N_RANK>
 struct Pochoir_Shape {
     /* N_RANK + 1 because we probably have to include the time dimension
@@ -100,10 +126,132 @@ struct Pochoir_Shape {
 template <int N_RANK, size_t N>
 size_t ArraySize (Pochoir_Shape<N_RANK> (& arr)[N]) { return N; }
 
+/* the shape of an ensemble of independent instances of a problem of 
+ * shape 'shape' : the instance index is the first spatial index, right
+ * after the time, with a shift of 0 everywhere, so no instance reads 
+ * another one. A Pochoir of rank N_RANK+1 with this shape, arrays of 
+ * n x (the size of one instance) and the domain [0, n) on the instance 
+ * index run all n instances in one walk, which cuts the instances apart
+ * (a dimension of slope 0) together with their space and time
+ */
+template <int N_RANK, size_t N>
+void Pochoir_Ensemble_Shape(Pochoir_Shape<N_RANK> const (& shape)[N], Pochoir_Shape<N_RANK+1> (& ensemble)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        ensemble[i].shift[0] = shape[i].shift[0];
+        ensemble[i].shift[1] = 0;
+        for (int r = 1; r < N_RANK+1; ++r)
+            ensemble[i].shift[r+1] = shape[i].shift[r];
+    }
+}
+
 #define KLEIN 0
 #define USE_CILK_FOR 0
 #define BICUT 1
 #define STAT 0
+#define MAX_NUMA_NODE 64
+/* POCHOIR_DATAFLOW : the sub-zoids of a hyperspace cut start as soon as 
+ * the neighbors they depend on are done, instead of waiting on a 
+ * cilk_sync after each dependency level
+ */
+#ifndef POCHOIR_DATAFLOW
+#define POCHOIR_DATAFLOW 0
+#endif
+/* walker of Run(timestep, f, bf) and Run_Obase() :
+ * - POCHOIR_WALK_TRAP : the cache-oblivious trapezoidal decomposition
+ * - POCHOIR_WALK_DIAMOND : diamond tiles of a fixed size, cut out of 
+ *   bands of dt_recursive_ time steps (pochoir_walk_diamond.hpp)
+ * POCHOIR_DEFAULT_WALK is what a new Pochoir object starts with, and
+ * Pochoir::Set_Walk() picks the walker of the following Runs
+ */
+enum Pochoir_Walk_Type { POCHOIR_WALK_TRAP, POCHOIR_WALK_DIAMOND };
+#ifndef POCHOIR_DEFAULT_WALK
+#define POCHOIR_DEFAULT_WALK POCHOIR_WALK_TRAP
+#endif
+/* where a Run() stops, see Pochoir::Set_Run_End() :
+ * - POCHOIR_END_EXACT : after exactly 'timestep' steps
+ * - POCHOIR_END_BAND : at the end of the band it stops in, the bands 
+ *   being counted from time step 0, so that a series of short Runs walks
+ *   the same zoids as one long Run
+ */
+enum Pochoir_End_Type { POCHOIR_END_EXACT, POCHOIR_END_BAND };
+
+/* how the toggle buffer of a Pochoir_Array is allocated and initialized :
+ * - POCHOIR_ALLOC_SERIAL : new T[] and zero-filled by the calling thread,
+ *   so all pages end up on the node of the calling thread
+ * - POCHOIR_ALLOC_FIRST_TOUCH : pages are first touched in parallel,
+ *   following the space cuts of the walkers
+ * - POCHOIR_ALLOC_MMAP : a shared mapping of a file, paged in and out
+ *   by the kernel, so the toggle buffer may exceed the physical memory,
+ *   and a later run restarts from the file by simply mapping it again
+ * - POCHOIR_ALLOC_USER : a buffer owned by the application, which 
+ *   Pochoir_Array::adopt() wraps without a copy, and never frees
+ */
+enum Pochoir_Alloc_Type { POCHOIR_ALLOC_SERIAL, POCHOIR_ALLOC_FIRST_TOUCH, POCHOIR_ALLOC_MMAP, POCHOIR_ALLOC_USER };
+
+/* madvise() hint for a POCHOIR_ALLOC_MMAP array :
+ * - POCHOIR_MADV_AUTO : MADV_WILLNEED if the mapping fits in half of the
+ *   physical memory (prefetch the whole file on restart), MADV_RANDOM
+ *   otherwise, since the recursive space cuts visit slabs out of address
+ *   order and readahead past the current zoid only evicts pages the walk
+ *   still needs
+ * - the others are passed to madvise() as they are
+ */
+enum Pochoir_Mmap_Advice { POCHOIR_MADV_AUTO, POCHOIR_MADV_NORMAL, POCHOIR_MADV_SEQUENTIAL, POCHOIR_MADV_RANDOM, POCHOIR_MADV_WILLNEED };
+
+/* memory layout of each time plane of a Pochoir_Array :
+ * - POCHOIR_LAYOUT_DENSE : plain row-major, no padding
+ * - POCHOIR_LAYOUT_PADDED : row-major, rows and time planes aligned to 
+ *   POCHOIR_ALIGN bytes, and the leading dimension padded to break up
+ *   power-of-two strides
+ * - POCHOIR_LAYOUT_BRICK : rows (dimension 0) are kept whole and contiguous,
+ *   and grouped into bricks of POCHOIR_BRICK rows along each of the other
+ *   dimensions; bricks are row-major, and so are the rows inside a brick
+ * - POCHOIR_LAYOUT_MORTON : bricks as above, with the rows inside a brick in
+ *   Morton (Z) order
+ * A bricked array has no stride() beyond dimension 0, only the offset 
+ * tables of layout_offset(), so the generated kernels have to be compiled
+ * with -split-opt-pointer or -split-macro-shadow.
+ * The layout is the LAYOUT template argument of Pochoir_Array, e.g. 
+ * Pochoir_Array<double, 3, 2, Pochoir_BValue_Fn, POCHOIR_LAYOUT_BRICK>,
+ * POCHOIR_DEFAULT_LAYOUT if it is left out.
+ */
+enum Pochoir_Layout_Type { POCHOIR_LAYOUT_DENSE, POCHOIR_LAYOUT_PADDED, POCHOIR_LAYOUT_BRICK, POCHOIR_LAYOUT_MORTON };
+#ifndef POCHOIR_DEFAULT_LAYOUT
+#define POCHOIR_DEFAULT_LAYOUT POCHOIR_LAYOUT_DENSE
+#endif
+/* edge of a brick in rows, has to be a power of two */
+#ifndef POCHOIR_BRICK
+#define POCHOIR_BRICK 8
+#endif
+#define POCHOIR_ALIGN 64
+
+/* page size backing the toggle buffer of a Pochoir_Array :
+ * - POCHOIR_PAGE_SMALL : whatever malloc gives us
+ * - POCHOIR_PAGE_HUGE_2M / POCHOIR_PAGE_HUGE_1G : hugetlbfs pages if the
+ *   system has enough of them reserved, otherwise 2MB transparent huge
+ *   pages, otherwise small pages
+ * The trapezoidal walk touches many widely separated rows and planes at
+ * once, which costs a dTLB miss on nearly every one of them with 4KB pages.
+ * POCHOIR_DEFAULT_PAGE is what a new array starts with, e.g.
+ * -DPOCHOIR_DEFAULT_PAGE=POCHOIR_PAGE_HUGE_2M
+ */
+enum Pochoir_Page_Type { POCHOIR_PAGE_SMALL, POCHOIR_PAGE_HUGE_2M, POCHOIR_PAGE_HUGE_1G };
+#ifndef POCHOIR_DEFAULT_PAGE
+#define POCHOIR_DEFAULT_PAGE POCHOIR_PAGE_SMALL
+#endif
+#define POCHOIR_CONFLICT_SIZE 512
+/* the cache level (1, 2 or 3) which a base-case zoid should fit, with
+ * the cache sizes of sysfs; 0 keeps the fixed stopping sizes
+ */
+#ifndef POCHOIR_CACHE_LEVEL
+#define POCHOIR_CACHE_LEVEL 2
+#endif
+/* file name of the tuning database (pochoir_tune.hpp), unless 
+ * $POCHOIR_TUNE_DB is set
+ */
+#ifndef POCHOIR_TUNE_DB
+#define POCHOIR_TUNE_DB "pochoir_tune.db"
+#endif
 static bool inRun = false;
 static int home_cell_[9];
 
@@ -174,6 +322,15 @@ static inline void klein_region(grid_info<2> & grid, grid_info<2> const & initia
 #define Pochoir_Array_7D(type) Pochoir_Array<type, 7>
 #define Pochoir_Array_8D(type) Pochoir_Array<type, 8>
 
+#define Pochoir_SoA_Array_1D(type) Pochoir_SoA_Array<type, 1>
+#define Pochoir_SoA_Array_2D(type) Pochoir_SoA_Array<type, 2>
+#define Pochoir_SoA_Array_3D(type) Pochoir_SoA_Array<type, 3>
+#define Pochoir_SoA_Array_4D(type) Pochoir_SoA_Array<type, 4>
+#define Pochoir_SoA_Array_5D(type) Pochoir_SoA_Array<type, 5>
+#define Pochoir_SoA_Array_6D(type) Pochoir_SoA_Array<type, 6>
+#define Pochoir_SoA_Array_7D(type) Pochoir_SoA_Array<type, 7>
+#define Pochoir_SoA_Array_8D(type) Pochoir_SoA_Array<type, 8>
+
 #define Pochoir_Shape_1D Pochoir_Shape<1>
 #define Pochoir_Shape_2D Pochoir_Shape<2>
 #define Pochoir_Shape_3D Pochoir_Shape<3>
@@ -236,43 +393,93 @@ static inline void klein_region(grid_info<2> & grid, grid_info<2> const & initia
 #define Pochoir_Obase_Fn_8D(name, t0, t1, grid) \
     auto name = [&](int t0, int t1, grid_info<8> const & grid) {
 
-/* - these function templates are for computing boundary values, currently
- *   icc doesn't support capturing the lambda function by function objects,
- *   so, we have to utilize the function pointers!
+/* - these function templates are for computing boundary values; a
+ *   Pochoir_Array registers either the function template itself as a
+ *   function pointer (the default), or the functor type name_fn that comes 
+ *   with it as its BF parameter, so that the call gets inlined
  * - because these functions will be called inside T & operator() functions,
- *   so we have to return a value of T&
+ *   so we have to return a value of T
+ * - T_Array is either Pochoir_Array or Pochoir_SoA_Array
  */
 #define Pochoir_Boundary_1D(name, arr, t, i) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 1> & arr, int t, int i) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i) const { return name(arr, t, i); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i) { 
 
 #define Pochoir_Boundary_2D(name, arr, t, i, j) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 2> & arr, int t, int i, int j) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j) const { return name(arr, t, i, j); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j) { 
 
 #define Pochoir_Boundary_3D(name, arr, t, i, j, k) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 3> & arr, int t, int i, int j, int k) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k) const { return name(arr, t, i, j, k); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k) { 
 
 #define Pochoir_Boundary_4D(name, arr, t, i, j, k, l) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 4> & arr, int t, int i, int j, int k, int l) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k, int l) const { return name(arr, t, i, j, k, l); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l) { 
 
 #define Pochoir_Boundary_5D(name, arr, t, i, j, k, l, m) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 5> & arr, int t, int i, int j, int k, int l, int m) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k, int l, int m) const { return name(arr, t, i, j, k, l, m); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m) { 
 
 #define Pochoir_Boundary_6D(name, arr, t, i, j, k, l, m, n) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 6> & arr, int t, int i, int j, int k, int l, int m, int n) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k, int l, int m, int n) const { return name(arr, t, i, j, k, l, m, n); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n) { 
 
 #define Pochoir_Boundary_7D(name, arr, t, i, j, k, l, m, n, o) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 7> & arr, int t, int i, int j, int k, int l, int m, int n, int o) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o) const { return name(arr, t, i, j, k, l, m, n, o); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o) { 
 
 #define Pochoir_Boundary_8D(name, arr, t, i, j, k, l, m, n, o, p) \
-    template <typename T> \
-    T name (Pochoir_Array<T, 8> & arr, int t, int i, int j, int k, int l, int m, int n, int o, int p) { 
+    template <typename T_Array> \
+    typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o, int p); \
+    struct name##_fn { \
+        template <typename T_Array> \
+        POCHOIR_FORCE_INLINE typename T_Array::value_type operator() (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o, int p) const { return name(arr, t, i, j, k, l, m, n, o, p); } \
+    }; \
+    template <typename T_Array> \
+    inline typename T_Array::value_type name (T_Array & arr, int t, int i, int j, int k, int l, int m, int n, int o, int p) { 
 
 #define Pochoir_Boundary_End }
 
@@ -0,0 +1,550 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ * 		                     Charles E. Leiserson <cel@mit.edu>
+ * 	 
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ ********************************************************************************/
+
+#ifndef POCHOIR_CONST_ARRAY_H
+#define POCHOIR_CONST_ARRAY_H
+
+#include "pochoir_common.hpp"
+#include "pochoir_array.hpp"
+
+/* Pochoir_Const_Array is a read-only, time-invariant field, such as the 
+ * velocity model of a wave equation or the obstacle flags of LBM :
+ * - a single plane of total_size() elements, no toggle buffer, and it is
+ *   indexed by the spatial dimensions only, e.g. vsq(i, j, k)
+ * - the kernel only reads it, there is no non-const operator(); the 
+ *   values are written through set() (or data()) before the first Run
+ * - its accesses are not part of the shape : reading a field that never 
+ *   changes carries no dependence between time steps, so it adds nothing 
+ *   to the slopes or the toggle
+ * - a dimension of size 1 is broadcast over the grid : its stride is 0 
+ *   and any index of it reads the one element, so a depth profile of a 
+ *   3D stencil is a Pochoir_Const_Array<T, 3> prof(Nz, 1, 1), and a 
+ *   per-plane constant one of (1, Ny, 1). It has to be registered after
+ *   an array of the full size, which sets the grid
+ * The memory is allocated when it is registered with a Pochoir object, the
+ * same as for a Pochoir_Array. The boundary function takes the spatial 
+ * indices only, so the one of a Pochoir_Const_Array<T, 3> is declared with
+ * Pochoir_Boundary_2D, e.g. 
+ *   Pochoir_Boundary_2D(vsq_bv, arr, i, j, k)
+ *       return arr.get(wrap(i), wrap(j), wrap(k));
+ *   Pochoir_Boundary_End
+ */
+template <typename T, int N_RANK>
+class Pochoir_Const_Array {
+	private:
+		Storage<T> * view_;
+        T * data_;
+		typedef int size_info[N_RANK];
+		size_info logic_size_;
+		size_info logic_start_, logic_end_; 
+		size_info phys_size_;
+        /* size of the grid, which a dimension of size 1 is broadcast over */
+		size_info grid_size_;
+		T_index stride_[N_RANK];
+        std::vector<T_index> off_tab_[N_RANK];
+        T_index const * off_[N_RANK];
+        bool allocMemFlag_;
+        Pochoir_Alloc_Type alloc_type_;
+        Pochoir_Page_Type page_type_;
+		T_index total_size_;
+        typedef typename Pochoir_BValue_Ptr<Pochoir_Const_Array<T, N_RANK>, T, N_RANK-1>::type BValue;
+        BValue bv_;
+
+        /* _size[] is ordered from the highest dimension down, 
+         * the same as the constructor arguments
+         */
+        void init(int const * _size) {
+            for (int i = 0; i < N_RANK; ++i) {
+                logic_size_[i] = phys_size_[i] = grid_size_[i] = _size[N_RANK-1-i];
+                logic_start_[i] = 0; logic_end_[i] = phys_size_[i];
+            }
+			stride_[0] = 1;  
+            for (int i = 0; i < N_RANK-1; ++i)
+				stride_[i+1] = stride_[i] * phys_size_[i];
+            total_size_ = stride_[N_RANK-1] * phys_size_[N_RANK-1];
+            for (int i = 0; i < N_RANK; ++i) {
+                if (phys_size_[i] == 1)
+                    stride_[i] = 0;
+            }
+            init_layout_offset();
+            view_ = NULL; data_ = NULL;
+            bv_ = NULL;
+            allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
+        }
+
+        void copy(Pochoir_Const_Array<T, N_RANK> const & orig) {
+			total_size_ = orig.total_size();
+			for (int i = 0; i < N_RANK; ++i) {
+				phys_size_[i] = orig.phys_size(i);
+				logic_size_[i] = orig.logic_size(i);
+				grid_size_[i] = orig.grid_size_[i];
+				stride_[i] = orig.stride(i);
+                logic_start_[i] = 0; logic_end_[i] = logic_size_[i];
+			}
+            init_layout_offset();
+            view_ = orig.view_;
+            data_ = orig.data_;
+            allocMemFlag_ = orig.allocMemFlag_;
+            if (allocMemFlag_)
+                view_->inc_ref();
+            bv_ = orig.bv_;
+            alloc_type_ = orig.alloc_type_;
+            page_type_ = orig.page_type_;
+        }
+
+        /* always row-major, these are the tables of layout_offset(), 
+         * the one of a broadcast dimension is all zeros over the grid
+         */
+        void init_layout_offset(void) {
+            for (int i = 1; i < N_RANK; ++i) {
+                int const l_size = grid_size_[i];
+                off_tab_[i].resize(3 * (T_index)l_size);
+                for (int x = -l_size; x < 2 * l_size; ++x)
+                    off_tab_[i][x + l_size] = x * stride_[i];
+                off_[i] = &off_tab_[i][l_size];
+            }
+        }
+
+        inline void check_alloc(void) const {
+            if (!allocMemFlag_) {
+                printf("Pochoir array access error:\n");
+                printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
+                exit(1);
+            }
+        }
+
+        /* _idx[] is ordered from the highest spatial dimension down,
+         * a broadcast dimension has no boundary
+         */
+        inline bool check_boundary(int const * _idx) const {
+            bool touch_boundary = false;
+            for (int i = 0; i < N_RANK; ++i) {
+                touch_boundary |= (stride_[i] != 0)
+                                & ((_idx[N_RANK-1-i] < logic_start_[i])
+                                | (_idx[N_RANK-1-i] >= logic_end_[i]));
+            }
+            return touch_boundary;
+        }
+
+        POCHOIR_FORCE_INLINE T_index offset(int const * _idx) const {
+            T_index l_idx = 0;
+            for (int i = 0; i < N_RANK; ++i)
+                l_idx += _idx[N_RANK-1-i] * stride_[i];
+            return l_idx;
+        }
+
+	public:
+        typedef T value_type;
+        explicit Pochoir_Const_Array (int sz0) {
+            int const l_size[1] = {sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz1, int sz0) {
+            int const l_size[2] = {sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz2, int sz1, int sz0) {
+            int const l_size[3] = {sz2, sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[4] = {sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[5] = {sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[6] = {sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz6, int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[7] = {sz6, sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+        explicit Pochoir_Const_Array (int sz7, int sz6, int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[8] = {sz7, sz6, sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+		/* Copy constructor -- create another view of the
+		 * same array
+		 */
+		Pochoir_Const_Array (Pochoir_Const_Array<T, N_RANK> const & orig) {
+            copy(orig);
+		}
+
+        /* assignment operator for vector<> */
+		Pochoir_Const_Array<T, N_RANK> & operator= (Pochoir_Const_Array<T, N_RANK> const & orig) {
+            if (this != &orig) {
+                if (allocMemFlag_)
+                    view_->dec_ref();
+                copy(orig);
+            }
+            return *this;
+		}
+
+		~Pochoir_Const_Array() {
+            if (allocMemFlag_)
+                view_->dec_ref();
+            allocMemFlag_ = false;
+		}
+
+        inline T * data() { return data_; }
+        BValue bv(void) { return bv_; }
+        void Register_Boundary(BValue _bv) { bv_ = _bv; }
+        void unRegister_Boundary(void) { bv_ = NULL; }
+
+        void Register_Domain(grid_info<N_RANK> initial_grid) {
+            for (int i = 0; i < N_RANK; ++i) {
+                logic_start_[i] = initial_grid.x0[i];
+                logic_end_[i] = initial_grid.x1[i];
+                logic_size_[i] = initial_grid.x1[i] - initial_grid.x0[i];
+            }
+        }
+
+        /* the physical grid of the Pochoir object it is registered with */
+        void set_grid_size(grid_info<N_RANK> const & _phys_grid) {
+            for (int i = 0; i < N_RANK; ++i)
+                grid_size_[i] = _phys_grid.x1[i] - _phys_grid.x0[i];
+            init_layout_offset();
+        }
+        /* has to be called before the array is registered with a Pochoir
+         * object, which is where the memory gets allocated
+         */
+        void set_alloc_type(Pochoir_Alloc_Type _alloc_type) { alloc_type_ = _alloc_type; }
+        void set_page_type(Pochoir_Page_Type _page_type) { page_type_ = _page_type; }
+        /* one plane, first touched by slabs of the highest dimension 
+         * like the planes of a Pochoir_Array
+         */
+        void alloc_mem(void) {
+            if (!allocMemFlag_) {
+                if (alloc_type_ == POCHOIR_ALLOC_FIRST_TOUCH) {
+                    view_ = new Storage<T>(1, total_size_, phys_size_[N_RANK-1], total_size_ / phys_size_[N_RANK-1], page_type_);
+                } else {
+                    view_ = new Storage<T>(total_size_, page_type_);
+                }
+                if (page_type_ != POCHOIR_PAGE_SMALL)
+                    view_->print_huge_pages();
+                data_ = view_->data();
+                allocMemFlag_ = true;
+            }
+        }
+
+		/* return size */
+		int phys_size(int _dim) const { return phys_size_[_dim]; }
+		int logic_size(int _dim) const { return logic_size_[_dim]; }
+		int size(int _dim) const { return phys_size_[_dim]; }
+		T_index total_size() const { return total_size_; }
+		T_index stride (int _dim) const { return stride_[_dim]; }
+        template <int DIM>
+		T_index stride (void) const { return stride_[DIM]; }
+        T_index const * layout_offset(int _dim) const { return off_[_dim]; }
+
+		/* index operator() for the format of a(i, j, k), there is no
+         * time dimension
+         */
+		inline T operator() (int _idx0) const {
+            check_alloc();
+            int const l_idx[1] = {_idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		/* the interior (non-checking) version */
+		inline T interior (int _idx0) const {
+            int const l_idx[1] = {_idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx1, int _idx0) const {
+            int const l_idx[2] = {_idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T interior (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		/* the boundary (checking, no registration check) version */
+		inline T boundary (int _idx0) const {
+            int const l_idx[1] = {_idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx1, int _idx0) const {
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		inline T boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_Const_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : data_[offset(l_idx)]);
+		}
+
+		/* read by the boundary function, which must stay in range */
+		inline T get (int _idx0) const {
+            int const l_idx[1] = {_idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx1, int _idx0) const {
+            int const l_idx[2] = {_idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		inline T get (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            if (check_boundary(l_idx)) {
+                printf("Pochoir illegal access by boundary function error:\n");
+                printf("Out-of-range access by boundary function of a Pochoir_Const_Array\n");
+                exit(1);
+            }
+            return data_[offset(l_idx)];
+		}
+
+		/* write the field before the run, there is no boundary value 
+         * to write to
+         */
+		inline T & set (int _idx0) {
+            check_alloc();
+            int const l_idx[1] = {_idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[2] = {_idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+
+		inline T & set (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return data_[offset(l_idx)];
+		}
+};
+
+#endif // POCHOIR_CONST_ARRAY_H
@@ -0,0 +1,799 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ * 		                     Charles E. Leiserson <cel@mit.edu>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ *********************************************************************************
+ */
+
+#ifndef POCHOIR_PARALLEL_H
+#define POCHOIR_PARALLEL_H
+
+/* the fork-join runtime the walkers run on, selected at compile time by
+ * -DPOCHOIR_BACKEND=... :
+ * - POCHOIR_BACKEND_SERIAL : every spawn is a plain call
+ * - POCHOIR_BACKEND_CILK : Cilk Plus (icpc, or g++ -fcilkplus)
+ * - POCHOIR_BACKEND_THREADS : the work-stealing scheduler below, on top
+ *   of std::thread only, one Chase-Lev deque per worker
+ * - POCHOIR_BACKEND_OPENMP : OpenMP tasks (-fopenmp)
+ * - POCHOIR_BACKEND_TBB : Intel TBB task groups (-ltbb)
+ * The default is Cilk Plus if the compiler speaks it, the built-in
+ * scheduler otherwise.
+ *
+ * The walkers are written against the macros below, which keep the
+ * spawn/sync structure of the Cilk code :
+ *      pochoir_task_frame;     (at the top of a function which spawns)
+ *      pochoir_spawn(f(a, b));
+ *      g(c, d);
+ *      pochoir_sync;
+ *      pochoir_for (j, lb, ub) { ... } pochoir_for_end;
+ * and the outermost call into a walker goes through pochoir_run(),
+ * which enters the parallel region of the runtime, if it has one.
+ * As in Cilk, the arguments of a spawned call are evaluated at the spawn,
+ * and a function implicitly syncs its children when it returns.
+ *
+ * For the NUMA hybrid decomposition (POCHOIR_NUMA), 
+ *      pochoir_on_nodes([&](int node) { ... });
+ * runs the body once for each of the pochoir_numa_nodes() nodes, on the
+ * workers of that node, and waits for all of them.
+ */
+#define POCHOIR_BACKEND_SERIAL 0
+#define POCHOIR_BACKEND_CILK 1
+#define POCHOIR_BACKEND_THREADS 2
+#define POCHOIR_BACKEND_OPENMP 3
+#define POCHOIR_BACKEND_TBB 4
+
+#ifndef POCHOIR_BACKEND
+#if defined(__cilk)
+#define POCHOIR_BACKEND POCHOIR_BACKEND_CILK
+#else
+#define POCHOIR_BACKEND POCHOIR_BACKEND_THREADS
+#endif
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <memory>
+/* for Run_Async() with every runtime, and before the max() / min() 
+ * macros of pochoir_common.hpp, which the standard headers choke on
+ */
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+
+/* POCHOIR_NUMA : the walkers split the grid into one slab per NUMA node 
+ * along the highest spatial dimension, and POCHOIR_ALLOC_FIRST_TOUCH 
+ * touches the same slabs from the same nodes; with POCHOIR_BACKEND_THREADS
+ * the workers are pinned to the cpus of their node, and steal mostly from
+ * the workers of their node; the other runtimes place the slabs as they
+ * like
+ */
+#ifndef POCHOIR_NUMA
+#define POCHOIR_NUMA 0
+#endif
+
+/* parse a sysfs cpu list like "0-3,8-11" */
+static inline void pochoir_parse_cpulist(char const * _list, std::vector<int> & _cpus) {
+    char const * l_p = _list;
+    while (*l_p != '\0' && *l_p != '\n') {
+        char * l_end;
+        long l_lo = std::strtol(l_p, &l_end, 10), l_hi = l_lo;
+        if (l_end == l_p)
+            break;
+        if (*l_end == '-')
+            l_hi = std::strtol(l_end + 1, &l_end, 10);
+        for (long c = l_lo; c <= l_hi; ++c)
+            _cpus.push_back((int)c);
+        l_p = (*l_end == ',') ? l_end + 1 : l_end;
+    }
+}
+
+/* the cpus of every NUMA node which has some, from sysfs; 
+ * $POCHOIR_NUMA_NODES=k splits the online cpus into k nodes instead, 
+ * e.g. one per L3 of a chiplet cpu, or to try it on a single node
+ */
+static inline std::vector<std::vector<int> > const & pochoir_numa_cpus(void) {
+    static std::vector<std::vector<int> > l_nodes;
+    if (!l_nodes.empty())
+        return l_nodes;
+    char l_buf[4096];
+    const char * l_env = std::getenv("POCHOIR_NUMA_NODES");
+    FILE * l_fp = fopen("/sys/devices/system/node/online", "r");
+    if (l_env == NULL && l_fp != NULL && fgets(l_buf, sizeof(l_buf), l_fp) != NULL) {
+        std::vector<int> l_ids;
+        pochoir_parse_cpulist(l_buf, l_ids);
+        for (size_t i = 0; i < l_ids.size(); ++i) {
+            char l_path[128];
+            snprintf(l_path, sizeof(l_path), "/sys/devices/system/node/node%d/cpulist", l_ids[i]);
+            FILE * l_node = fopen(l_path, "r");
+            std::vector<int> l_cpus;
+            if (l_node != NULL && fgets(l_buf, sizeof(l_buf), l_node) != NULL)
+                pochoir_parse_cpulist(l_buf, l_cpus);
+            if (l_node != NULL)
+                fclose(l_node);
+            if (!l_cpus.empty())
+                l_nodes.push_back(l_cpus);
+        }
+    }
+    if (l_fp != NULL)
+        fclose(l_fp);
+    if (l_nodes.empty()) {
+        int l_ncpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        int l_k = (l_env != NULL) ? std::atoi(l_env) : 1;
+        l_ncpus = (l_ncpus > 0) ? l_ncpus : 1;
+        l_k = (l_k > 0) ? l_k : 1;
+        for (int n = 0; n < l_k; ++n) {
+            std::vector<int> l_cpus;
+            for (int c = l_ncpus * n / l_k; c < l_ncpus * (n + 1) / l_k; ++c)
+                l_cpus.push_back(c);
+            /* more nodes than cpus : the nodes share them */
+            if (l_cpus.empty())
+                l_cpus.push_back(n % l_ncpus);
+            l_nodes.push_back(l_cpus);
+        }
+    }
+    return l_nodes;
+}
+
+/* the first of _len rows (or slabs) of node _n out of _nnodes */
+static inline int pochoir_numa_slab(int _n, int _nnodes, int _len) {
+    return (int)((long)_len * _n / _nnodes);
+}
+
+#if POCHOIR_BACKEND == POCHOIR_BACKEND_CILK
+
+#include <cilk/cilk.h>
+#include <cilk/cilk_api.h>
+#include <cilk/reducer_opadd.h>
+
+#define pochoir_task_frame
+#define pochoir_spawn(...) cilk_spawn __VA_ARGS__
+#define pochoir_sync cilk_sync
+#define pochoir_for(var, lb, ub) cilk_for (int var = (lb); var < (ub); ++var)
+#define pochoir_for_end
+
+template <typename Fn>
+inline void pochoir_run(Fn const & _fn) { _fn(); }
+
+static inline int pochoir_get_nworkers(void) { return __cilkrts_get_nworkers(); }
+
+static inline int pochoir_set_nworkers(const char * _nstr) {
+    return __cilkrts_set_param("nworkers", _nstr);
+}
+
+template <typename T>
+struct pochoir_reducer_opadd : public cilk::reducer_opadd<T> { };
+
+#else /* POCHOIR_BACKEND != POCHOIR_BACKEND_CILK */
+
+#include <atomic>
+
+#define pochoir_task_frame pochoir_task_group l_pochoir_tasks
+#define pochoir_spawn(...) l_pochoir_tasks.spawn([=]() { __VA_ARGS__; })
+#define pochoir_sync l_pochoir_tasks.wait()
+#define pochoir_for(var, lb, ub) pochoir_parallel_for((lb), (ub), [&](int var)
+#define pochoir_for_end )
+
+/* without Cilk, the hand-written loops of the examples run as plain
+ * loops, or OpenMP loops with the OpenMP backend
+ */
+#ifndef cilk_spawn
+#define cilk_spawn
+#define cilk_sync
+#if POCHOIR_BACKEND == POCHOIR_BACKEND_OPENMP
+#define cilk_for _Pragma("omp parallel for") for
+#else
+#define cilk_for for
+#endif
+#endif
+
+/* the counters of STAT, a plain atomic stands in for the Cilk reducer */
+template <typename T>
+class pochoir_reducer_opadd {
+    private:
+        std::atomic<T> value_;
+    public:
+        pochoir_reducer_opadd() : value_(0) { }
+        pochoir_reducer_opadd & operator++ () {
+            value_.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+        pochoir_reducer_opadd & operator+= (T const & _v) {
+            value_.fetch_add(_v, std::memory_order_relaxed);
+            return *this;
+        }
+        T get_value() const { return value_.load(); }
+};
+
+#if POCHOIR_BACKEND == POCHOIR_BACKEND_SERIAL
+
+class pochoir_task_group {
+    public:
+        template <typename Fn>
+        void spawn(Fn const & _fn) { _fn(); }
+        void wait() { }
+};
+
+template <typename Fn>
+inline void pochoir_run(Fn const & _fn) { _fn(); }
+
+static inline int pochoir_get_nworkers(void) { return 1; }
+
+static inline int pochoir_set_nworkers(const char * _nstr) { return (std::atoi(_nstr) == 1 ? 0 : 1); }
+
+#elif POCHOIR_BACKEND == POCHOIR_BACKEND_OPENMP
+
+#include <omp.h>
+
+/* a taskwait waits for all children of the current OpenMP task, which
+ * is a superset of the children spawned by the calling function, so a
+ * pochoir_sync may also wait for siblings spawned by a caller running
+ * in the same task; that is stricter than a Cilk sync but still correct
+ */
+class pochoir_task_group {
+    public:
+        ~pochoir_task_group() { wait(); }
+        template <typename Fn>
+        void spawn(Fn const & _fn) {
+            Fn l_fn(_fn);
+#pragma omp task firstprivate(l_fn)
+            l_fn();
+        }
+        void wait() {
+#pragma omp taskwait
+        }
+};
+
+template <typename Fn>
+inline void pochoir_run(Fn const & _fn) {
+    if (omp_in_parallel()) {
+        _fn();
+        return;
+    }
+#pragma omp parallel
+#pragma omp single
+    _fn();
+}
+
+static inline int pochoir_get_nworkers(void) { return omp_get_max_threads(); }
+
+static inline int pochoir_set_nworkers(const char * _nstr) {
+    int l_n = std::atoi(_nstr);
+    if (l_n <= 0 || omp_in_parallel())
+        return 1;
+    omp_set_num_threads(l_n);
+    return 0;
+}
+
+#elif POCHOIR_BACKEND == POCHOIR_BACKEND_TBB
+
+#include <memory>
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#include <tbb/global_control.h>
+
+class pochoir_task_group {
+    private:
+        tbb::task_group group_;
+    public:
+        ~pochoir_task_group() { group_.wait(); }
+        template <typename Fn>
+        void spawn(Fn const & _fn) { group_.run(_fn); }
+        void wait() { group_.wait(); }
+};
+
+template <typename Body>
+inline void pochoir_parallel_for(int _lb, int _ub, Body const & _body) {
+    tbb::parallel_for(_lb, _ub, _body);
+}
+
+/* the limit on the number of workers, POCHOIR_NWORKERS in the environment
+ * sets the initial one
+ */
+static inline std::unique_ptr<tbb::global_control> & pochoir_tbb_control(void) {
+    static std::unique_ptr<tbb::global_control> l_control;
+    static bool l_init = false;
+    if (!l_init) {
+        l_init = true;
+        const char * l_env = std::getenv("POCHOIR_NWORKERS");
+        if (l_env != NULL && std::atoi(l_env) > 0)
+            l_control.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, std::atoi(l_env)));
+    }
+    return l_control;
+}
+
+template <typename Fn>
+inline void pochoir_run(Fn const & _fn) {
+    pochoir_tbb_control();
+    _fn();
+}
+
+static inline int pochoir_get_nworkers(void) {
+    pochoir_tbb_control();
+    return (int)tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+}
+
+static inline int pochoir_set_nworkers(const char * _nstr) {
+    int l_n = std::atoi(_nstr);
+    if (l_n <= 0)
+        return 1;
+    pochoir_tbb_control().reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, l_n));
+    return 0;
+}
+
+#elif POCHOIR_BACKEND == POCHOIR_BACKEND_THREADS
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+
+/* the built-in work-stealing scheduler :
+ * - every worker owns a Chase-Lev deque of tasks, it pushes and pops its
+ *   own spawns at the bottom, thieves take the oldest (biggest) ones from
+ *   the top; a full deque makes the spawn run inline
+ * - the thread calling pochoir_run() becomes worker 0 for the duration
+ *   of the call, the other workers are started on the first run and
+ *   sleep while no run is active; spawns from a thread which is not a
+ *   worker (e.g. a second application thread) run inline
+ * - a sync keeps popping its own deque down to the tasks of its frame,
+ *   then steals, until all children of the frame have completed
+ * - the number of workers comes from pochoir_set_nworkers(), or
+ *   POCHOIR_NWORKERS / CILK_NWORKERS in the environment, or the number
+ *   of hardware threads
+ * - with POCHOIR_NUMA, the workers are split into consecutive groups, 
+ *   one per NUMA node, and pinned to the cpus of their node; a thief 
+ *   tries the workers of its node, and only every POCHOIR_REMOTE_STEAL-th
+ *   attempt another one; pochoir_on_nodes() posts the task of a node to
+ *   the inbox of the node, which only its workers take from
+ */
+#ifndef POCHOIR_DEQUE_SIZE
+#define POCHOIR_DEQUE_SIZE (1 << 12)
+#endif
+#ifndef POCHOIR_REMOTE_STEAL
+#define POCHOIR_REMOTE_STEAL 8
+#endif
+
+struct pochoir_task {
+    std::atomic<int> * pending_;
+    explicit pochoir_task(std::atomic<int> * _pending) : pending_(_pending) { }
+    virtual ~pochoir_task() { }
+    virtual void execute() = 0;
+};
+
+template <typename Fn>
+struct pochoir_task_impl : public pochoir_task {
+    Fn fn_;
+    pochoir_task_impl(Fn const & _fn, std::atomic<int> * _pending) : pochoir_task(_pending), fn_(_fn) { }
+    void execute() { fn_(); }
+};
+
+class pochoir_deque {
+    private:
+        std::atomic<long> top_;
+        char pad0_[64];
+        std::atomic<long> bottom_;
+        char pad1_[64];
+        std::atomic<pochoir_task *> buf_[POCHOIR_DEQUE_SIZE];
+    public:
+        pochoir_deque() : top_(0), bottom_(0) { }
+        /* called by the owner only */
+        long bottom() const { return bottom_.load(std::memory_order_relaxed); }
+        bool push(pochoir_task * _task) {
+            long b = bottom_.load(std::memory_order_relaxed);
+            long t = top_.load(std::memory_order_acquire);
+            if (b - t >= POCHOIR_DEQUE_SIZE)
+                return false;
+            buf_[b & (POCHOIR_DEQUE_SIZE - 1)].store(_task, std::memory_order_relaxed);
+            /* publishes the task to the thieves reading bottom_ */
+            bottom_.store(b + 1, std::memory_order_release);
+            return true;
+        }
+        /* called by the owner only, never pops below _base */
+        pochoir_task * pop(long _base) {
+            long b = bottom_.load(std::memory_order_relaxed) - 1;
+            if (b < _base)
+                return NULL;
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long t = top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                /* empty */
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return NULL;
+            }
+            pochoir_task * l_task = buf_[b & (POCHOIR_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                /* the last one, race against the thieves */
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    l_task = NULL;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return l_task;
+        }
+        pochoir_task * steal() {
+            long t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long b = bottom_.load(std::memory_order_acquire);
+            if (t >= b)
+                return NULL;
+            pochoir_task * l_task = buf_[t & (POCHOIR_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return NULL;
+            return l_task;
+        }
+};
+
+/* the tasks posted to one NUMA node by pochoir_on_nodes() */
+class pochoir_inbox {
+    private:
+        std::mutex mutex_;
+        std::vector<pochoir_task *> tasks_;
+        std::atomic<int> size_;
+    public:
+        pochoir_inbox() : size_(0) { }
+        void post(pochoir_task * _task) {
+            std::lock_guard<std::mutex> l_lock(mutex_);
+            tasks_.push_back(_task);
+            size_.fetch_add(1, std::memory_order_release);
+        }
+        pochoir_task * take() {
+            if (size_.load(std::memory_order_acquire) == 0)
+                return NULL;
+            std::lock_guard<std::mutex> l_lock(mutex_);
+            if (tasks_.empty())
+                return NULL;
+            pochoir_task * l_task = tasks_.back();
+            tasks_.pop_back();
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return l_task;
+        }
+};
+
+class pochoir_scheduler {
+    private:
+        int nworkers_;
+        std::vector<pochoir_deque *> deques_;
+        std::vector<std::thread> threads_;
+        std::atomic<bool> done_;
+        std::atomic<int> active_;
+        std::mutex run_mutex_, idle_mutex_;
+        std::condition_variable idle_cv_;
+        /* POCHOIR_NUMA : the workers of node n are [node_first_[n], 
+         * node_first_[n+1])
+         */
+        int nnodes_;
+        std::vector<int> node_of_, node_first_;
+        std::vector<pochoir_inbox *> inboxes_;
+
+        pochoir_scheduler() : nworkers_(0), done_(false), active_(0), nnodes_(1) {
+            const char * l_env = std::getenv("POCHOIR_NWORKERS");
+            if (l_env == NULL)
+                l_env = std::getenv("CILK_NWORKERS");
+            if (l_env != NULL)
+                nworkers_ = std::atoi(l_env);
+            if (nworkers_ <= 0)
+                nworkers_ = (int)std::thread::hardware_concurrency();
+            if (nworkers_ <= 0)
+                nworkers_ = 1;
+            set_nodes();
+        }
+        ~pochoir_scheduler() { stop(); }
+
+        void set_nodes() {
+            nnodes_ = 1;
+#if POCHOIR_NUMA
+            int l_nodes = (int)pochoir_numa_cpus().size();
+            nnodes_ = (l_nodes < nworkers_) ? l_nodes : nworkers_;
+#endif
+            node_of_.resize(nworkers_);
+            node_first_.resize(nnodes_ + 1);
+            for (int n = 0; n <= nnodes_; ++n)
+                node_first_[n] = pochoir_numa_slab(n, nnodes_, nworkers_);
+            for (int n = 0; n < nnodes_; ++n)
+                for (int i = node_first_[n]; i < node_first_[n+1]; ++i)
+                    node_of_[i] = n;
+        }
+        /* pin a thread to the cpus of node _n */
+        void pin(pthread_t _thread, int _n) {
+#if POCHOIR_NUMA && defined(CPU_SET)
+            std::vector<int> const & l_cpus = pochoir_numa_cpus()[_n];
+            cpu_set_t l_set;
+            CPU_ZERO(&l_set);
+            for (size_t i = 0; i < l_cpus.size(); ++i)
+                CPU_SET(l_cpus[i], &l_set);
+            pthread_setaffinity_np(_thread, sizeof(l_set), &l_set);
+#else
+            (void) _thread; (void) _n;
+#endif
+        }
+
+        static unsigned & seed() { static __thread unsigned l_seed = 0; return l_seed; }
+        void backoff(int & _fails) {
+            if (++_fails < 64)
+                return;
+            std::this_thread::yield();
+        }
+        /* a random victim other than _id among the workers [_lb, _ub) */
+        pochoir_task * steal_any(int _id, int _lb, int _ub) {
+            unsigned & l_seed = seed();
+            l_seed = l_seed * 1103515245u + 12345u;
+            int l_victim = _lb + (int)((l_seed >> 16) % (unsigned)(_ub - _lb - 1));
+            if (l_victim >= _id)
+                ++l_victim;
+            return deques_[l_victim]->steal();
+        }
+        /* the inbox of the node first, then the workers of the node, 
+         * and every POCHOIR_REMOTE_STEAL-th time any worker
+         */
+        pochoir_task * steal_any(int _id) {
+            if (nworkers_ <= 1)
+                return NULL;
+            if (nnodes_ <= 1)
+                return steal_any(_id, 0, nworkers_);
+            const int l_node = node_of_[_id];
+            pochoir_task * l_task = inboxes_[l_node]->take();
+            if (l_task != NULL)
+                return l_task;
+            const int l_lb = node_first_[l_node], l_ub = node_first_[l_node+1];
+            if (l_ub - l_lb > 1 && (seed() >> 8) % POCHOIR_REMOTE_STEAL != 0)
+                return steal_any(_id, l_lb, l_ub);
+            return steal_any(_id, 0, nworkers_);
+        }
+        static void execute(pochoir_task * _task) {
+            std::atomic<int> * l_pending = _task->pending_;
+            _task->execute();
+            delete _task;
+            l_pending->fetch_sub(1, std::memory_order_release);
+        }
+        void worker_loop(int _id) {
+            worker_id() = _id;
+            seed() = 2654435761u * (unsigned)(_id + 1);
+            int l_fails = 0;
+            while (!done_.load(std::memory_order_acquire)) {
+                pochoir_task * l_task = steal_any(_id);
+                if (l_task != NULL) {
+                    execute(l_task);
+                    l_fails = 0;
+                    continue;
+                }
+                if (active_.load(std::memory_order_acquire) > 0) {
+                    backoff(l_fails);
+                    continue;
+                }
+                std::unique_lock<std::mutex> l_lock(idle_mutex_);
+                if (active_.load() == 0 && !done_.load())
+                    idle_cv_.wait_for(l_lock, std::chrono::milliseconds(1));
+            }
+        }
+        void start() {
+            if (!threads_.empty() || nworkers_ <= 1)
+                return;
+            done_ = false;
+            for (int i = 0; i < nworkers_; ++i)
+                deques_.push_back(new pochoir_deque());
+            for (int n = 0; n < nnodes_; ++n)
+                inboxes_.push_back(new pochoir_inbox());
+            for (int i = 1; i < nworkers_; ++i) {
+                threads_.push_back(std::thread(&pochoir_scheduler::worker_loop, this, i));
+                if (nnodes_ > 1)
+                    pin(threads_.back().native_handle(), node_of_[i]);
+            }
+        }
+        void stop() {
+            {
+                std::lock_guard<std::mutex> l_lock(idle_mutex_);
+                done_ = true;
+            }
+            idle_cv_.notify_all();
+            for (size_t i = 0; i < threads_.size(); ++i)
+                threads_[i].join();
+            threads_.clear();
+            for (size_t i = 0; i < deques_.size(); ++i)
+                delete deques_[i];
+            deques_.clear();
+            for (size_t i = 0; i < inboxes_.size(); ++i)
+                delete inboxes_[i];
+            inboxes_.clear();
+        }
+    public:
+        static pochoir_scheduler & instance() { static pochoir_scheduler l_sched; return l_sched; }
+        /* -1 if the calling thread is not a worker of an active run */
+        static int & worker_id() { static __thread int l_id = -1; return l_id; }
+        int nworkers() const { return nworkers_; }
+        int nnodes() const { return nnodes_; }
+        int set_nworkers(int _n) {
+            if (_n <= 0 || worker_id() >= 0)
+                return 1;
+            std::lock_guard<std::mutex> l_lock(run_mutex_);
+            stop();
+            nworkers_ = _n;
+            set_nodes();
+            return 0;
+        }
+        template <typename Fn>
+        void run(Fn const & _fn) {
+            if (worker_id() >= 0 || nworkers_ <= 1) {
+                _fn();
+                return;
+            }
+            std::unique_lock<std::mutex> l_lock(run_mutex_, std::try_to_lock);
+            if (!l_lock.owns_lock()) {
+                /* another application thread owns the workers */
+                _fn();
+                return;
+            }
+            start();
+            worker_id() = 0;
+#if POCHOIR_NUMA && defined(CPU_SET)
+            /* the calling thread is worker 0 on node 0 for the run */
+            cpu_set_t l_old_set;
+            bool l_pinned = (nnodes_ > 1 && pthread_getaffinity_np(pthread_self(), sizeof(l_old_set), &l_old_set) == 0);
+            if (l_pinned)
+                pin(pthread_self(), 0);
+#endif
+            {
+                std::lock_guard<std::mutex> l_idle(idle_mutex_);
+                active_.fetch_add(1);
+            }
+            idle_cv_.notify_all();
+            _fn();
+            active_.fetch_sub(1);
+#if POCHOIR_NUMA && defined(CPU_SET)
+            if (l_pinned)
+                pthread_setaffinity_np(pthread_self(), sizeof(l_old_set), &l_old_set);
+#endif
+            worker_id() = -1;
+        }
+        template <typename Fn>
+        void spawn(Fn const & _fn, std::atomic<int> & _pending) {
+            int l_id = worker_id();
+            if (l_id < 0) {
+                _fn();
+                return;
+            }
+            pochoir_task * l_task = new pochoir_task_impl<Fn>(_fn, &_pending);
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            if (!deques_[l_id]->push(l_task))
+                execute(l_task);
+        }
+        long frame_base() {
+            int l_id = worker_id();
+            return (l_id < 0 ? 0 : deques_[l_id]->bottom());
+        }
+        /* _fn(n) for every node n, the one of the caller in place */
+        template <typename Fn>
+        void on_nodes(Fn const & _fn) {
+            int l_id = worker_id();
+            if (l_id < 0 || nnodes_ <= 1) {
+                for (int n = 0; n < nnodes_; ++n)
+                    _fn(n);
+                return;
+            }
+            std::atomic<int> l_pending(0);
+            long l_base = frame_base();
+            for (int n = 0; n < nnodes_; ++n) {
+                if (n == node_of_[l_id])
+                    continue;
+                auto l_fn = [&_fn, n]() { _fn(n); };
+                l_pending.fetch_add(1, std::memory_order_relaxed);
+                inboxes_[n]->post(new pochoir_task_impl<decltype(l_fn)>(l_fn, &l_pending));
+            }
+            _fn(node_of_[l_id]);
+            wait(l_pending, l_base);
+        }
+        void wait(std::atomic<int> & _pending, long _base) {
+            int l_id = worker_id();
+            int l_fails = 0;
+            while (_pending.load(std::memory_order_acquire) > 0) {
+                pochoir_task * l_task = deques_[l_id]->pop(_base);
+                if (l_task == NULL)
+                    l_task = steal_any(l_id);
+                if (l_task != NULL) {
+                    execute(l_task);
+                    l_fails = 0;
+                } else {
+                    backoff(l_fails);
+                }
+            }
+        }
+};
+
+class pochoir_task_group {
+    private:
+        std::atomic<int> pending_;
+        long base_;
+    public:
+        pochoir_task_group() : pending_(0), base_(pochoir_scheduler::instance().frame_base()) { }
+        ~pochoir_task_group() { wait(); }
+        template <typename Fn>
+        void spawn(Fn const & _fn) { pochoir_scheduler::instance().spawn(_fn, pending_); }
+        void wait() {
+            if (pending_.load(std::memory_order_acquire) > 0)
+                pochoir_scheduler::instance().wait(pending_, base_);
+        }
+};
+
+template <typename Fn>
+inline void pochoir_run(Fn const & _fn) { pochoir_scheduler::instance().run(_fn); }
+
+static inline int pochoir_get_nworkers(void) { return pochoir_scheduler::instance().nworkers(); }
+
+static inline int pochoir_set_nworkers(const char * _nstr) {
+    return pochoir_scheduler::instance().set_nworkers(std::atoi(_nstr));
+}
+
+static inline int pochoir_numa_nodes(void) { return pochoir_scheduler::instance().nnodes(); }
+
+template <typename Fn>
+inline void pochoir_on_nodes(Fn const & _fn) { pochoir_scheduler::instance().on_nodes(_fn); }
+
+#else
+#error "Pochoir : unknown POCHOIR_BACKEND"
+#endif
+
+#if POCHOIR_BACKEND != POCHOIR_BACKEND_TBB
+/* bisect [_lb, _ub) down to single iterations, the same way a cilk_for
+ * with grainsize 1 does
+ */
+template <typename Body>
+inline void pochoir_parallel_for(int _lb, int _ub, Body const & _body) {
+    if (_ub - _lb <= 1) {
+        if (_ub > _lb)
+            _body(_lb);
+        return;
+    }
+    pochoir_task_frame;
+    const int l_mid = _lb + (_ub - _lb) / 2;
+    Body const * l_body = &_body;
+    pochoir_spawn(pochoir_parallel_for(_lb, l_mid, *l_body));
+    pochoir_parallel_for(l_mid, _ub, _body);
+    pochoir_sync;
+}
+#endif
+
+#endif /* POCHOIR_BACKEND != POCHOIR_BACKEND_CILK */
+
+#if POCHOIR_BACKEND != POCHOIR_BACKEND_THREADS
+/* no say in where the tasks run : one slab per node all the same, so 
+ * that the walkers and the first touch agree on the slabs
+ */
+static inline int pochoir_numa_nodes(void) {
+#if POCHOIR_NUMA
+    int l_nodes = (int)pochoir_numa_cpus().size();
+    return (l_nodes < pochoir_get_nworkers()) ? l_nodes : pochoir_get_nworkers();
+#else
+    return 1;
+#endif
+}
+
+template <typename Fn>
+inline void pochoir_on_nodes(Fn const & _fn) {
+    pochoir_for (n, 0, pochoir_numa_nodes()) {
+        _fn(n);
+    } pochoir_for_end;
+}
+#endif
+
+#endif /* POCHOIR_PARALLEL_H */
@@ -0,0 +1,701 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ * 		                     Charles E. Leiserson <cel@mit.edu>
+ * 	 
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ ********************************************************************************/
+
+#ifndef POCHOIR_SOA_ARRAY_H
+#define POCHOIR_SOA_ARRAY_H
+
+#include "pochoir_common.hpp"
+#include "pochoir_array.hpp"
+
+/* Structure-of-arrays storage for struct element types.
+ * The struct has to be declared with Pochoir_SoA_Struct() from an X-macro
+ * listing its fields, e.g.
+ *
+ *   #define Cell_Fields(F) F(double, _C) F(double, _N) F(unsigned int, _FLAGS)
+ *   Pochoir_SoA_Struct(Cell, Cell_Fields)
+ *
+ * which declares the plain struct Cell (still usable with Pochoir_Array)
+ * and a Pochoir_SoA_Traits<Cell> with :
+ * - field_xxx : ordinal of field xxx
+ * - type_xxx : type of field xxx
+ * - ref_type / bref_type : proxies holding one reference per field, so 
+ *   that pa(t, i, j).xxx reads and writes the plane of field xxx directly
+ */
+template <typename T>
+struct Pochoir_SoA_Traits;
+
+#define Pochoir_SoA_Field_Decl(type, fname) type fname;
+#define Pochoir_SoA_Field_Enum(type, fname) field_##fname,
+#define Pochoir_SoA_Field_Type(type, fname) typedef type type_##fname;
+#define Pochoir_SoA_Field_Size(type, fname) _size[field_##fname] = sizeof(type);
+#define Pochoir_SoA_Field_Ref(type, fname) type & fname;
+#define Pochoir_SoA_Field_Init(type, fname) fname(((type *)_base[field_##fname])[_idx]),
+#define Pochoir_SoA_Field_Bind(type, fname) fname(bvalue_.fname),
+#define Pochoir_SoA_Field_Copy(type, fname) fname(_r.boundary_ ? bvalue_.fname : _r.fname),
+#define Pochoir_SoA_Field_Get(type, fname) l_value.fname = fname;
+#define Pochoir_SoA_Field_Set(type, fname) fname = _value.fname;
+
+/* - ref_type binds straight to the field planes, which is all the
+ *   interior (non-checking) accesses need
+ * - bref_type is returned by the checking accesses : a boundary value has
+ *   no home in the field planes, so it keeps the value in bvalue_ and 
+ *   binds all references to it
+ * both have to be inlined all the way down, so that the references to the
+ * fields not in use are thrown away
+ */
+#define Pochoir_SoA_Struct(name, FIELDS) \
+struct name { FIELDS(Pochoir_SoA_Field_Decl) }; \
+template <> \
+struct Pochoir_SoA_Traits<name> { \
+    enum { FIELDS(Pochoir_SoA_Field_Enum) n_fields }; \
+    FIELDS(Pochoir_SoA_Field_Type) \
+    static void field_size(size_t * _size) { FIELDS(Pochoir_SoA_Field_Size) } \
+    struct ref_type { \
+        FIELDS(Pochoir_SoA_Field_Ref) \
+        POCHOIR_FORCE_INLINE ref_type(char * const * _base, T_index _idx) : FIELDS(Pochoir_SoA_Field_Init) dummy_(0) { } \
+        POCHOIR_FORCE_INLINE operator name () const { name l_value; FIELDS(Pochoir_SoA_Field_Get) return l_value; } \
+        POCHOIR_FORCE_INLINE ref_type & operator= (name const & _value) { FIELDS(Pochoir_SoA_Field_Set) return *this; } \
+        POCHOIR_FORCE_INLINE ref_type & operator= (ref_type const & _r) { return (*this = (name)_r); } \
+        int dummy_; \
+    }; \
+    struct bref_type { \
+        bool boundary_; \
+        name bvalue_; \
+        FIELDS(Pochoir_SoA_Field_Ref) \
+        POCHOIR_FORCE_INLINE bref_type(char * const * _base, T_index _idx) : boundary_(false), FIELDS(Pochoir_SoA_Field_Init) dummy_(0) { } \
+        POCHOIR_FORCE_INLINE bref_type(name const & _bvalue) : boundary_(true), bvalue_(_bvalue), FIELDS(Pochoir_SoA_Field_Bind) dummy_(0) { } \
+        POCHOIR_FORCE_INLINE bref_type(bref_type const & _r) : boundary_(_r.boundary_), bvalue_(_r.bvalue_), FIELDS(Pochoir_SoA_Field_Copy) dummy_(0) { } \
+        POCHOIR_FORCE_INLINE operator name () const { name l_value; FIELDS(Pochoir_SoA_Field_Get) return l_value; } \
+        POCHOIR_FORCE_INLINE bref_type & operator= (name const & _value) { FIELDS(Pochoir_SoA_Field_Set) return *this; } \
+        POCHOIR_FORCE_INLINE bref_type & operator= (bref_type const & _r) { return (*this = (name)_r); } \
+        int dummy_; \
+    }; \
+};
+
+/* Pochoir_SoA_Array has the same interface as Pochoir_Array, except that
+ * each field of T lives in its own toggle buffer (a "field plane"),
+ * laid out exactly like the toggle buffer of a Pochoir_Array<T>.
+ * Hence the linear index of (t, i, j, ...) is the same for all fields,
+ * and the generated pointer code only needs one index per array access
+ * and one base pointer per field in use.
+ */
+template <typename T, int N_RANK, int TOGGLE = 2>
+class Pochoir_SoA_Array {
+    public:
+        typedef Pochoir_SoA_Traits<T> traits_type;
+        typedef typename traits_type::ref_type ref_type;
+        typedef typename traits_type::bref_type bref_type;
+        enum { n_fields = traits_type::n_fields };
+	private:
+        Storage<char> * view_[n_fields]; /* one toggle buffer per field */
+        char * base_[n_fields];
+        size_t field_size_[n_fields];
+		typedef int size_info[N_RANK];
+		size_info logic_size_;
+		size_info logic_start_, logic_end_; 
+		size_info phys_size_;
+		T_index stride_[N_RANK];
+        std::vector<T_index> off_tab_[N_RANK];
+        T_index const * off_[N_RANK];
+        bool allocMemFlag_;
+        Pochoir_Alloc_Type alloc_type_;
+        std::string mmap_file_;
+        Pochoir_Mmap_Advice mmap_advice_;
+        Pochoir_Page_Type page_type_;
+		T_index total_size_;
+        int slope_[N_RANK], toggle_;
+        T_index toggle_offset_[TOGGLE];
+        typedef typename Pochoir_BValue_Ptr<Pochoir_SoA_Array<T, N_RANK, TOGGLE>, T, N_RANK>::type BValue;
+        BValue bv_;
+
+        /* _size[] is ordered from the highest dimension down, 
+         * the same as the constructor arguments
+         */
+        void init(int const * _size) {
+            for (int i = 0; i < N_RANK; ++i) {
+                logic_size_[i] = phys_size_[i] = _size[N_RANK-1-i];
+                logic_start_[i] = 0; logic_end_[i] = phys_size_[i];
+            }
+			stride_[0] = 1;  
+            for (int i = 0; i < N_RANK-1; ++i)
+				stride_[i+1] = stride_[i] * phys_size_[i];
+            total_size_ = stride_[N_RANK-1] * phys_size_[N_RANK-1];
+            init_layout_offset();
+            for (int k = 0; k < n_fields; ++k) {
+                view_[k] = NULL; base_[k] = NULL;
+            }
+            traits_type::field_size(field_size_);
+            bv_ = NULL;
+            allocMemFlag_ = false;
+            alloc_type_ = POCHOIR_ALLOC_FIRST_TOUCH;
+            mmap_advice_ = POCHOIR_MADV_AUTO;
+            page_type_ = POCHOIR_DEFAULT_PAGE;
+        }
+
+        void copy(Pochoir_SoA_Array<T, N_RANK, TOGGLE> const & orig) {
+			total_size_ = orig.total_size();
+			for (int i = 0; i < N_RANK; ++i) {
+				phys_size_[i] = orig.phys_size(i);
+				logic_size_[i] = orig.logic_size(i);
+				stride_[i] = orig.stride(i);
+                logic_start_[i] = 0; logic_end_[i] = logic_size_[i];
+			}
+            init_layout_offset();
+            for (int k = 0; k < n_fields; ++k) {
+                view_[k] = orig.view_[k];
+                view_[k]->inc_ref();
+                base_[k] = view_[k]->data();
+                field_size_[k] = orig.field_size_[k];
+            }
+            bv_ = orig.bv_;
+            alloc_type_ = orig.alloc_type_;
+            set_toggle_offset();
+            allocMemFlag_ = true;
+        }
+
+        /* a Pochoir_SoA_Array is always row-major, these are the tables
+         * of Pochoir_Array::layout_offset() for it
+         */
+        void init_layout_offset(void) {
+            for (int i = 1; i < N_RANK; ++i) {
+                int const l_size = phys_size_[i];
+                off_tab_[i].resize(3 * (T_index)l_size);
+                for (int x = -l_size; x < 2 * l_size; ++x)
+                    off_tab_[i][x + l_size] = x * stride_[i];
+                off_[i] = &off_tab_[i][l_size];
+            }
+        }
+
+        inline void check_alloc(void) const {
+            if (!allocMemFlag_) {
+                printf("Pochoir array access error:\n");
+                printf("A Pochoir array is accessed without being registered with a Pochoir object.\n");
+                exit(1);
+            }
+        }
+
+        /* _idx[0] is the time dimension, followed by the spatial 
+         * dimensions from the highest down
+         */
+        inline bool check_boundary(int const * _idx) const {
+            bool touch_boundary = false;
+            for (int i = 0; i < N_RANK; ++i) {
+                touch_boundary |= (_idx[N_RANK-i] < logic_start_[i]
+                                | _idx[N_RANK-i] >= logic_end_[i]);
+            }
+            return touch_boundary;
+        }
+
+        POCHOIR_FORCE_INLINE T_index offset(int const * _idx) const {
+            T_index l_idx = time_offset(_idx[0]);
+            for (int i = 0; i < N_RANK; ++i)
+                l_idx += _idx[N_RANK-i] * stride_[i];
+            return l_idx;
+        }
+
+	public:
+        typedef T value_type;
+        explicit Pochoir_SoA_Array (int sz0) {
+            int const l_size[1] = {sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz1, int sz0) {
+            int const l_size[2] = {sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz2, int sz1, int sz0) {
+            int const l_size[3] = {sz2, sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[4] = {sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[5] = {sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[6] = {sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz6, int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[7] = {sz6, sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+        explicit Pochoir_SoA_Array (int sz7, int sz6, int sz5, int sz4, int sz3, int sz2, int sz1, int sz0) {
+            int const l_size[8] = {sz7, sz6, sz5, sz4, sz3, sz2, sz1, sz0};
+            init(l_size);
+        }
+
+		/* Copy constructor -- create another view of the
+		 * same array
+		 */
+		Pochoir_SoA_Array (Pochoir_SoA_Array<T, N_RANK, TOGGLE> const & orig) {
+            copy(orig);
+		}
+
+        /* assignment operator for vector<> */
+		Pochoir_SoA_Array<T, N_RANK, TOGGLE> & operator= (Pochoir_SoA_Array<T, N_RANK, TOGGLE> const & orig) {
+            copy(orig);
+            return *this;
+		}
+
+		~Pochoir_SoA_Array() {
+            if (allocMemFlag_) {
+                for (int k = 0; k < n_fields; ++k)
+                    view_[k]->dec_ref();
+            }
+            allocMemFlag_ = false;
+		}
+
+        /* base of the field plane of field _field, to be cast to 
+         * traits_type::type_xxx *
+         */
+        inline char * field_data(int _field) { return base_[_field]; }
+
+        /* take a copy of all field planes, and return what puts them back,
+         * the same as Pochoir_Array::backup()
+         */
+        std::function<void ()> backup(std::set<void const *> & _done) {
+            if (!allocMemFlag_)
+                return [](){};
+            std::vector<Storage<char> *> l_view;
+            for (int k = 0; k < n_fields; ++k)
+                if (_done.insert(view_[k]).second)
+                    l_view.push_back(view_[k]);
+            std::shared_ptr<std::vector<std::vector<char> > > l_copy(new std::vector<std::vector<char> >(l_view.size()));
+            for (size_t k = 0; k < l_view.size(); ++k)
+                (*l_copy)[k].assign(l_view[k]->data(), l_view[k]->data() + l_view[k]->size());
+            return [l_view, l_copy]() {
+                for (size_t k = 0; k < l_view.size(); ++k)
+                    std::copy((*l_copy)[k].begin(), (*l_copy)[k].end(), l_view[k]->data());
+            };
+        }
+
+        BValue bv(void) { return bv_; }
+        void Register_Boundary(BValue _bv) { bv_ = _bv; }
+        void unRegister_Boundary(void) { bv_ = NULL; }
+
+        void Register_Domain(grid_info<N_RANK> initial_grid) {
+            for (int i = 0; i < N_RANK; ++i) {
+                logic_start_[i] = initial_grid.x0[i];
+                logic_end_[i] = initial_grid.x1[i];
+                logic_size_[i] = initial_grid.x1[i] - initial_grid.x0[i];
+            }
+        }
+
+        void Register_Shape(Pochoir_Shape<N_RANK> * shape, int shape_size) {
+            /* currently we just get the slope_[] and toggle_ out of the shape[] */
+            int l_min_time_shift=0, l_max_time_shift=0, depth=0;
+            for (int r = 0; r < N_RANK; ++r) {
+                slope_[r] = 0;
+            }
+            for (int i = 0; i < shape_size; ++i) {
+                if (shape[i].shift[0] < l_min_time_shift)
+                    l_min_time_shift = shape[i].shift[0];
+                if (shape[i].shift[0] > l_max_time_shift)
+                    l_max_time_shift = shape[i].shift[0];
+            }
+            depth = l_max_time_shift - l_min_time_shift;
+            toggle_ = depth + 1;
+            if (toggle_ != TOGGLE) {
+                printf("Pochoir array toggle error:\n");
+                printf("The shape has a time depth of %d, which needs a Pochoir_SoA_Array with toggle %d instead of %d!\n", depth, toggle_, TOGGLE);
+                exit(1);
+            }
+            for (int i = 0; i < shape_size; ++i) {
+                for (int r = 1; r < N_RANK+1; ++r) {
+                    slope_[N_RANK-r] = max(slope_[N_RANK-r], abs((int)ceil((float)shape[i].shift[r]/(l_max_time_shift - shape[i].shift[0]))));
+                }
+            }
+            if (!allocMemFlag_) {
+                alloc_mem();
+            }
+        }
+
+        template <size_t N_SIZE>
+        void Register_Shape(Pochoir_Shape<N_RANK> (& shape)[N_SIZE]) {
+            Register_Shape(shape, N_SIZE);
+        }
+
+        void set_toggle_offset(void) {
+            for (int i = 0; i < TOGGLE; ++i)
+                toggle_offset_[i] = i * total_size_;
+        }
+        inline T_index time_offset(int _t) const {
+            return ((TOGGLE & (TOGGLE - 1)) == 0) ? (_t & (TOGGLE - 1)) * total_size_ : toggle_offset_[_t % TOGGLE];
+        }
+        /* has to be called before the array is registered with a Pochoir
+         * object, which is where the memory gets allocated
+         */
+        void set_alloc_type(Pochoir_Alloc_Type _alloc_type) { alloc_type_ = _alloc_type; }
+        void set_page_type(Pochoir_Page_Type _page_type) { page_type_ = _page_type; }
+        /* one backing file per field, named _fname.<field index> */
+        void set_mmap_file(char const * _fname, Pochoir_Mmap_Advice _advice = POCHOIR_MADV_AUTO) {
+            alloc_type_ = POCHOIR_ALLOC_MMAP;
+            mmap_file_ = _fname;
+            mmap_advice_ = _advice;
+        }
+        /* each field plane is a Storage<char> of its own, 
+         * sized and sliced in bytes of that field
+         */
+        void alloc_mem(void) {
+            if (!allocMemFlag_) {
+                for (int k = 0; k < n_fields; ++k) {
+                    if (alloc_type_ == POCHOIR_ALLOC_FIRST_TOUCH) {
+                        view_[k] = new Storage<char>(TOGGLE, total_size_ * field_size_[k], phys_size_[N_RANK-1], stride_[N_RANK-1] * field_size_[k], page_type_);
+                    } else if (alloc_type_ == POCHOIR_ALLOC_MMAP) {
+                        char l_suffix[16];
+                        sprintf(l_suffix, ".%d", k);
+                        view_[k] = new Storage<char>((mmap_file_ + l_suffix).c_str(), TOGGLE * total_size_ * field_size_[k], mmap_advice_);
+                    } else {
+                        view_[k] = new Storage<char>(TOGGLE * total_size_ * field_size_[k], page_type_);
+                    }
+                    base_[k] = view_[k]->data();
+                    if (page_type_ != POCHOIR_PAGE_SMALL && alloc_type_ != POCHOIR_ALLOC_MMAP)
+                        view_[k]->print_huge_pages();
+                }
+                set_toggle_offset();
+                allocMemFlag_ = true;
+            }
+        }
+        void sync(void) {
+            for (int k = 0; k < n_fields; ++k)
+                view_[k]->sync();
+        }
+		/* return size */
+		int phys_size(int _dim) const { return phys_size_[_dim]; }
+		int logic_size(int _dim) const { return logic_size_[_dim]; }
+		int size(int _dim) const { return phys_size_[_dim]; }
+		T_index total_size() const { return total_size_; }
+		T_index stride (int _dim) const { return stride_[_dim]; }
+        template <int DIM>
+		T_index stride (void) const { return stride_[DIM]; }
+        T_index const * layout_offset(int _dim) const { return off_[_dim]; }
+
+		/* index operator() for the format of a(i, j, k) 
+         * - The highest dimension is always time dimension
+         * - the const version returns a copy of the struct
+         * - the non-const version returns a bref_type proxy
+         */
+		inline T operator() (int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            check_alloc();
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type operator() (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            check_alloc();
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		/* the interior (non-checking) version */
+		inline T interior (int _idx1, int _idx0) const {
+            int const l_idx[2] = {_idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		inline T interior (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return T(ref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx1, int _idx0) {
+            int const l_idx[2] = {_idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx2, int _idx1, int _idx0) {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		POCHOIR_FORCE_INLINE ref_type interior (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            return ref_type(base_, offset(l_idx));
+		}
+
+		/* the boundary (checking, no registration check) version */
+		inline T boundary (int _idx1, int _idx0) const {
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		inline T boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) const {
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bv_(const_cast<Pochoir_SoA_Array &>(*this), _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0) : T(ref_type(base_, offset(l_idx))));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx1, int _idx0) {
+            int const l_idx[2] = {_idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx2, int _idx1, int _idx0) {
+            int const l_idx[3] = {_idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[4] = {_idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[5] = {_idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[6] = {_idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[7] = {_idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[8] = {_idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+
+		POCHOIR_FORCE_INLINE bref_type boundary (int _idx8, int _idx7, int _idx6, int _idx5, int _idx4, int _idx3, int _idx2, int _idx1, int _idx0) {
+            int const l_idx[9] = {_idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0};
+            bool set_boundary = (bv_ != NULL && check_boundary(l_idx));
+            return (set_boundary ? bref_type(bv_(*this, _idx8, _idx7, _idx6, _idx5, _idx4, _idx3, _idx2, _idx1, _idx0)) : bref_type(base_, offset(l_idx)));
+		}
+};
+
+#endif // POCHOIR_SOA_ARRAY_H
@@ -0,0 +1,146 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ * 		                     Charles E. Leiserson <cel@mit.edu>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ *********************************************************************************
+ */
+
+#ifndef POCHOIR_TUNE_H
+#define POCHOIR_TUNE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <unistd.h>
+#include "pochoir_common.hpp"
+
+/* The tuning database keeps the recursion thresholds found by the 
+ * autotuner of Pochoir::Tune()/Tune_Obase(), one line per problem :
+ *
+ *   <key> dt <dt> <dt_boundary> dx <dx[0]> .. <dx[N-1]> dxb <dx_boundary[0]> ..
+ *
+ * The key is made of the walker, rank, bytes per grid point of all arrays,
+ * grid size, number of workers and a hash of the shape, 
+ * e.g. obase_p/r3/s16/g400x400x400/p16/1f2e3d4c (diamond_obase_p/... 
+ * with POCHOIR_WALK_DIAMOND),
+ * so a problem run with a different grid or core count is tuned anew.
+ * The file is $POCHOIR_TUNE_DB, or POCHOIR_TUNE_DB of pochoir_common.hpp
+ * in the current directory. Lines of other keys, and comments starting
+ * with '#', are kept as they are.
+ */
+static inline char const * pochoir_tune_db(void) {
+    char const * l_env = std::getenv("POCHOIR_TUNE_DB");
+    return (l_env != NULL && l_env[0] != '\0') ? l_env : POCHOIR_TUNE_DB;
+}
+
+/* POCHOIR_TUNE=1 in the environment makes Run()/Run_Obase() tune a 
+ * problem the database doesn't know yet, before running it
+ */
+static inline bool pochoir_tune_env(void) {
+    char const * l_env = std::getenv("POCHOIR_TUNE");
+    return (l_env != NULL && std::atoi(l_env) > 0);
+}
+
+template <int N_RANK>
+bool pochoir_tune_parse(std::string const & _line, std::string const & _key, thres_info<N_RANK> & _thres) {
+    std::istringstream l_in(_line);
+    std::string l_key, l_dt, l_dx, l_dxb;
+    thres_info<N_RANK> l_thres;
+    l_in >> l_key;
+    if (l_key != _key)
+        return false;
+    l_in >> l_dt >> l_thres.dt >> l_thres.dt_boundary >> l_dx;
+    for (int i = 0; i < N_RANK; ++i)
+        l_in >> l_thres.dx[i];
+    l_in >> l_dxb;
+    for (int i = 0; i < N_RANK; ++i)
+        l_in >> l_thres.dx_boundary[i];
+    bool l_ok = !l_in.fail() && l_dt == "dt" && l_dx == "dx" && l_dxb == "dxb"
+             && l_thres.dt >= 1 && l_thres.dt_boundary >= 1;
+    for (int i = 0; i < N_RANK; ++i)
+        l_ok = l_ok && l_thres.dx[i] >= 1 && l_thres.dx_boundary[i] >= 1;
+    if (l_ok)
+        _thres = l_thres;
+    return l_ok;
+}
+
+template <int N_RANK>
+bool pochoir_tune_load(std::string const & _key, thres_info<N_RANK> & _thres) {
+    FILE * l_fp = fopen(pochoir_tune_db(), "r");
+    char l_line[1024];
+    bool l_found = false;
+    if (l_fp == NULL)
+        return false;
+    while (!l_found && fgets(l_line, sizeof(l_line), l_fp) != NULL) {
+        l_found = pochoir_tune_parse(std::string(l_line), _key, _thres);
+    }
+    fclose(l_fp);
+    return l_found;
+}
+
+/* replace the line of _key, or append one; the new database is written
+ * aside and renamed over the old one, so a concurrent reader sees either
+ */
+template <int N_RANK>
+void pochoir_tune_store(std::string const & _key, thres_info<N_RANK> const & _thres) {
+    std::string const l_db = pochoir_tune_db();
+    std::vector<std::string> l_lines;
+    char l_line[1024];
+    FILE * l_fp = fopen(l_db.c_str(), "r");
+    if (l_fp != NULL) {
+        while (fgets(l_line, sizeof(l_line), l_fp) != NULL) {
+            std::istringstream l_in(l_line);
+            std::string l_key;
+            l_in >> l_key;
+            if (l_key != _key)
+                l_lines.push_back(l_line);
+        }
+        fclose(l_fp);
+    }
+    std::ostringstream l_out;
+    l_out << _key << " dt " << _thres.dt << " " << _thres.dt_boundary << " dx";
+    for (int i = 0; i < N_RANK; ++i)
+        l_out << " " << _thres.dx[i];
+    l_out << " dxb";
+    for (int i = 0; i < N_RANK; ++i)
+        l_out << " " << _thres.dx_boundary[i];
+    l_out << "\n";
+    l_lines.push_back(l_out.str());
+
+    std::ostringstream l_tmp;
+    l_tmp << l_db << ".tmp." << getpid();
+    l_fp = fopen(l_tmp.str().c_str(), "w");
+    bool l_ok = (l_fp != NULL);
+    for (size_t i = 0; l_ok && i < l_lines.size(); ++i)
+        l_ok = (fputs(l_lines[i].c_str(), l_fp) >= 0);
+    if (l_fp != NULL)
+        l_ok = (fclose(l_fp) == 0) && l_ok;
+    if (!l_ok || rename(l_tmp.str().c_str(), l_db.c_str()) != 0) {
+        unlink(l_tmp.str().c_str());
+        printf("Pochoir tuning error:\n");
+        printf("Can't write the tuning database %s!\n", l_db.c_str());
+        exit(1);
+    }
+}
+
+#endif /* POCHOIR_TUNE_H */
@@ -28,10 +28,10 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cassert>
+#include <cstring>
+#include <climits>
 #include <iostream>
-#include <cilk/cilk.h>
-#include <cilk/cilk_api.h>
-#include <cilk/reducer_opadd.h>
+#include <atomic>
 #include "pochoir_common.hpp"
 
 using namespace std;
@@ -52,7 +52,7 @@ struct meta_grid_boundary <8, BF>{
         for (int k = grid.x0[5]; k < grid.x1[5]; ++k) {
             int new_k = pmod_lu(k, initial_grid.x0[5], initial_grid.x1[5]);
             for (int l = grid.x0[4]; l < grid.x1[4]; ++l) {
-                int new_l = pmod_lu(l, initial_gird.x0[4], initial_grid.x1[4]);
+                int new_l = pmod_lu(l, initial_grid.x0[4], initial_grid.x1[4]);
         for (int m = grid.x0[3]; m < grid.x1[3]; ++m) {
             int new_m = pmod_lu(m, initial_grid.x0[3], initial_grid.x1[3]);
             for (int n = grid.x0[2]; n < grid.x1[2]; ++n) {
@@ -83,7 +83,7 @@ struct meta_grid_boundary <7, BF>{
         for (int k = grid.x0[4]; k < grid.x1[4]; ++k) {
             int new_k = pmod_lu(k, initial_grid.x0[4], initial_grid.x1[4]);
             for (int l = grid.x0[3]; l < grid.x1[3]; ++l) {
-                int new_l = pmod_lu(l, initial_gird.x0[3], initial_grid.x1[3]);
+                int new_l = pmod_lu(l, initial_grid.x0[3], initial_grid.x1[3]);
         for (int m = grid.x0[2]; m < grid.x1[2]; ++m) {
             int new_m = pmod_lu(m, initial_grid.x0[2], initial_grid.x1[2]);
             for (int n = grid.x0[1]; n < grid.x1[1]; ++n) {
@@ -112,7 +112,7 @@ struct meta_grid_boundary <6, BF>{
         for (int k = grid.x0[3]; k < grid.x1[3]; ++k) {
             int new_k = pmod_lu(k, initial_grid.x0[3], initial_grid.x1[3]);
             for (int l = grid.x0[2]; l < grid.x1[2]; ++l) {
-                int new_l = pmod_lu(l, initial_gird.x0[2], initial_grid.x1[2]);
+                int new_l = pmod_lu(l, initial_grid.x0[2], initial_grid.x1[2]);
         for (int m = grid.x0[1]; m < grid.x1[1]; ++m) {
             int new_m = pmod_lu(m, initial_grid.x0[1], initial_grid.x1[1]);
             for (int n = grid.x0[0]; n < grid.x1[0]; ++n) {
@@ -138,7 +138,7 @@ struct meta_grid_boundary <5, BF>{
         for (int k = grid.x0[2]; k < grid.x1[2]; ++k) {
             int new_k = pmod_lu(k, initial_grid.x0[2], initial_grid.x1[2]);
             for (int l = grid.x0[1]; l < grid.x1[1]; ++l) {
-                int new_l = pmod_lu(l, initial_gird.x0[1], initial_grid.x1[1]);
+                int new_l = pmod_lu(l, initial_grid.x0[1], initial_grid.x1[1]);
         for (int m = grid.x0[0]; m < grid.x1[0]; ++m) {
             int new_m = pmod_lu(m, initial_grid.x0[0], initial_grid.x1[0]);
                 if (inRun) {
@@ -162,7 +162,7 @@ struct meta_grid_boundary <4, BF>{
         for (int k = grid.x0[1]; k < grid.x1[1]; ++k) {
             int new_k = pmod_lu(k, initial_grid.x0[1], initial_grid.x1[1]);
             for (int l = grid.x0[0]; l < grid.x1[0]; ++l) {
-                int new_l = pmod_lu(l, initial_gird.x0[0], initial_grid.x1[0]);
+                int new_l = pmod_lu(l, initial_grid.x0[0], initial_grid.x1[0]);
                 if (inRun) {
                     home_cell_[4] = new_l; home_cell_[3] = new_k;
                     home_cell_[2] = new_j; home_cell_[1] = new_i;
@@ -343,7 +343,7 @@ struct meta_grid_interior <1, F>{
 static inline void set_worker_count(const char * nstr) 
 {
 #if 1
-    if (0 != __cilkrts_set_param("nworkers", nstr)) {
+    if (0 != pochoir_set_nworkers(nstr)) {
         printf("Failed to set worker count\n");
     } else {
         printf("Successfully set worker count to %s\n", nstr);
@@ -361,6 +361,79 @@ struct power<1> {
     enum {value = 5};
 }; 
 
+/* # of sub-zoids of a hyperspace cut : 3^N_RANK */
+template <int N_RANK>
+struct power3 {
+    enum { value = 3 * power3<N_RANK-1>::value };
+};
+
+template <>
+struct power3<1> {
+    enum {value = 3};
+}; 
+
+/* first line of a sysfs file, "" if there's none */
+static inline void pochoir_read_sysfs(char const * _path, char * _buf, int _len) {
+    FILE * l_fp = fopen(_path, "r");
+    _buf[0] = '\0';
+    if (l_fp == NULL)
+        return;
+    if (fgets(_buf, _len, l_fp) == NULL)
+        _buf[0] = '\0';
+    fclose(l_fp);
+}
+
+/* size in bytes of the data (or unified) cache of level 'level' of cpu0,
+ * divided by the # of cpus sharing it, as found in sysfs; 0 if unknown
+ */
+static inline long pochoir_cache_size(int level) {
+    static long l_size[4] = {-1, -1, -1, -1};
+    if (level < 1 || level > 3)
+        return 0;
+    if (l_size[level] >= 0)
+        return l_size[level];
+    long l_bytes = 0;
+    for (int i = 0; i < 16 && l_bytes == 0; ++i) {
+        char l_path[128], l_buf[256];
+        long l_size_kb = 0;
+        char l_unit = 'K';
+        int l_ncpus = 0;
+        snprintf(l_path, sizeof(l_path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+        pochoir_read_sysfs(l_path, l_buf, sizeof(l_buf));
+        if (l_buf[0] == '\0')
+            break;
+        if (atoi(l_buf) != level)
+            continue;
+        snprintf(l_path, sizeof(l_path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+        pochoir_read_sysfs(l_path, l_buf, sizeof(l_buf));
+        if (strncmp(l_buf, "Data", 4) != 0 && strncmp(l_buf, "Unified", 7) != 0)
+            continue;
+        snprintf(l_path, sizeof(l_path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+        pochoir_read_sysfs(l_path, l_buf, sizeof(l_buf));
+        if (sscanf(l_buf, "%ld%c", &l_size_kb, &l_unit) < 1)
+            continue;
+        l_bytes = l_size_kb * (l_unit == 'M' ? 1024 * 1024 : (l_unit == 'K' ? 1024 : 1));
+        /* shared_cpu_list is like "0-3,8-11" */
+        snprintf(l_path, sizeof(l_path), "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", i);
+        pochoir_read_sysfs(l_path, l_buf, sizeof(l_buf));
+        for (char * l_p = l_buf; *l_p != '\0' && *l_p != '\n'; ) {
+            int l_lo = 0, l_hi = 0, l_n = 0;
+            if (sscanf(l_p, "%d-%d%n", &l_lo, &l_hi, &l_n) == 2)
+                l_ncpus += l_hi - l_lo + 1;
+            else if (sscanf(l_p, "%d%n", &l_lo, &l_n) == 1)
+                l_ncpus += 1;
+            else
+                break;
+            l_p += l_n;
+            if (*l_p == ',')
+                ++l_p;
+        }
+        l_bytes /= (l_ncpus > 0 ? l_ncpus : 1);
+    }
+    l_size[level] = l_bytes;
+    return l_bytes;
+}
+
 template <int N_RANK>
 struct Algorithm {
 	private:
@@ -372,7 +445,7 @@ struct Algorithm {
         int dx_recursive_[N_RANK];
         int dx_recursive_boundary_[N_RANK];
         int dt_recursive_;
-        const int dt_recursive_boundary_;
+        int dt_recursive_boundary_;
         int Z;
         const int r_t; /* # of pieces cut in time dimension */
         int N_CORES;
@@ -383,29 +456,71 @@ struct Algorithm {
             grid_info<N_RANK> grid;
         } queue_info;
 
+        /* one dimension of a hyperspace cut for the dataflow walk : 
+         * the pieces from left to right, and whether a piece waits for 
+         * its neighbors on this dimension (the black trapezoids of a 
+         * bottom-bar cut, the gray minizoid of a top-bar cut)
+         */
+        typedef struct {
+            int n;
+            int x0[3], dx0[3], x1[3], dx1[3];
+            bool wait[3];
+        } cut_info;
+
+        /* the sub-zoids of a hyperspace cut are numbered in mixed radix 
+         * over the pieces of each dimension, count[] is the number of 
+         * neighbors each one is still waiting for
+         */
+        typedef struct {
+            int t0, t1;
+            cut_info cut[N_RANK];
+            int stride[N_RANK];
+            std::atomic<int> count[power3<N_RANK>::value];
+        } dataflow_info;
+
+        /* one dimension of a band of diamond tiles : 'n_up' upright 
+         * trapezoids 'w' wide at the bottom from 'x0' on, the last one 
+         * going up to 'x1', and 'n_gap' inverted ones in between, plus one 
+         * across 'x1' if the tiles 'wrap' around the periodic boundary;
+         * 'dx0'/'dx1' are the slopes of the outer sides if they don't
+         */
+        typedef struct {
+            int x0, x1, dx0, dx1;
+            int w, n_up, n_gap;
+            bool wrap;
+        } diamond_info;
+
         int ALGOR_QUEUE_SIZE;
 
         /* we can use toggled circular queue! */
         grid_info<N_RANK> phys_grid_;
         int phys_length_[N_RANK];
         int slope_[N_RANK];
+        /* the sides of the zoids of the shorter_duo_sim_obase and the
+         * walk_bicut walkers lean by slope0_ toward x0 and slope1_ toward x1;
+         * the other walkers lean both by slope_, the larger of the two
+         */
+        int slope0_[N_RANK], slope1_[N_RANK];
         int ulb_boundary[N_RANK], uub_boundary[N_RANK], lub_boundary[N_RANK];
         bool boundarySet, physGridSet, slopeSet;
 	public:
 #if STAT
     /* sim_count_cut will be accessed outside Algorithm object */
-    cilk::reducer_opadd<int> sim_count_cut[SUPPORT_RANK];
-    cilk::reducer_opadd<int> interior_region_count, boundary_region_count;
-    cilk::reducer_opadd<long long> interior_points_count, boundary_points_count;
+    pochoir_reducer_opadd<int> sim_count_cut[SUPPORT_RANK];
+    pochoir_reducer_opadd<int> interior_region_count, boundary_region_count;
+    pochoir_reducer_opadd<long long> interior_points_count, boundary_points_count;
 #endif
 
     typedef enum {TILE_NCORES, TILE_BOUNDARY, TILE_MP} algor_type;
     
     /* constructor */
-    Algorithm (int const _slope[]) : dt_recursive_boundary_(1), r_t(1) {
+    Algorithm (int const _slope[], int const _slope0[] = NULL, int const _slope1[] = NULL) : dt_recursive_boundary_(1), r_t(1) {
         for (int i = 0; i < N_RANK; ++i) {
             slope_[i] = _slope[i];
-            dx_recursive_boundary_[i] = _slope[i];
+            slope0_[i] = (_slope0 == NULL) ? _slope[i] : _slope0[i];
+            slope1_[i] = (_slope1 == NULL) ? _slope[i] : _slope1[i];
+            /* no boundary zoids to cut along a dimension of slope 0 */
+            dx_recursive_boundary_[i] = (_slope[i] == 0) ? INT_MAX : _slope[i];
 //            dx_recursive_boundary_[i] = tune_dx_boundary;
             ulb_boundary[i] = uub_boundary[i] = lub_boundary[i] = 0;
             // dx_recursive_boundary_[i] = 10;
@@ -422,7 +537,7 @@ struct Algorithm {
 //            sim_count_cut[i] = 0;
 //        }
 #else
-        N_CORES = __cilkrts_get_nworkers();
+        N_CORES = pochoir_get_nworkers();
 #endif
 //        cout << " N_CORES = " << N_CORES << endl;
 
@@ -454,6 +569,81 @@ struct Algorithm {
         printf("dx_thres[%d] = %d\n", 0, dx_recursive_[0]);
 #endif
     }
+    /* # of cells touched by a base-case zoid of height 'dt' if the dx 
+     * stops above are scaled by 'scale' : a zoid with a bottom of dx[i] 
+     * spans at most dx[i] + 2 * slope[i] * dt in dimension i
+     */
+    inline double base_case_cells(int dt, double scale) const {
+        double l_cells = 1;
+        for (int i = 0; i < N_RANK; ++i)
+            l_cells *= max(1.0, scale * dx_recursive_[i]) + 2.0 * slope_[i] * dt;
+        return l_cells;
+    }
+    /* as set_thres(arr_type_size), but with the base case sized to the
+     * POCHOIR_CACHE_LEVEL cache of one core, 'cell_bytes' being the bytes
+     * per grid point of all registered arrays with all their time planes :
+     * for each dt up to the fixed one, the dx stops are scaled together
+     * until the zoid fills the cache, and the dt doing the most updates
+     * per cell touched wins; the fixed stops stay if the cache size 
+     * can't be found
+     */
+    inline void set_thres(int arr_type_size, int cell_bytes) {
+        set_thres(arr_type_size);
+#if !DEBUG
+        long const l_cache = pochoir_cache_size(POCHOIR_CACHE_LEVEL);
+        if (l_cache <= 0 || cell_bytes <= 0)
+            return;
+        double const l_cells = (double)l_cache / cell_bytes;
+        double l_best_reuse = 0, l_best_scale = 1;
+        int l_best_dt = dt_recursive_;
+        for (int l_dt = dt_recursive_; l_dt >= 1; --l_dt) {
+            if (base_case_cells(l_dt, 0) > l_cells)
+                continue;
+            double l_lo = 0, l_hi = 1;
+            while (base_case_cells(l_dt, l_hi) < l_cells && l_hi < 1e6)
+                l_hi *= 2;
+            for (int l_iter = 0; l_iter < 50; ++l_iter) {
+                double const l_mid = (l_lo + l_hi) / 2;
+                if (base_case_cells(l_dt, l_mid) <= l_cells)
+                    l_lo = l_mid;
+                else
+                    l_hi = l_mid;
+            }
+            double l_reuse = l_dt / base_case_cells(l_dt, l_lo);
+            for (int i = 0; i < N_RANK; ++i)
+                l_reuse *= max(1.0, l_lo * dx_recursive_[i]);
+            if (l_reuse > l_best_reuse) {
+                l_best_reuse = l_reuse;
+                l_best_scale = l_lo;
+                l_best_dt = l_dt;
+            }
+        }
+        if (l_best_reuse == 0)
+            return;
+        dt_recursive_ = l_best_dt;
+        for (int i = 0; i < N_RANK; ++i)
+            dx_recursive_[i] = max(1, (int)(l_best_scale * dx_recursive_[i]));
+#endif
+    }
+    /* thresholds found by the autotuner (pochoir_tune.hpp), in place of
+     * the defaults above
+     */
+    inline void set_thres(thres_info<N_RANK> const & thres) {
+        dt_recursive_ = thres.dt;
+        dt_recursive_boundary_ = thres.dt_boundary;
+        for (int i = 0; i < N_RANK; ++i) {
+            dx_recursive_[i] = thres.dx[i];
+            dx_recursive_boundary_[i] = thres.dx_boundary[i];
+        }
+    }
+    inline void get_thres(thres_info<N_RANK> & thres) const {
+        thres.dt = dt_recursive_;
+        thres.dt_boundary = dt_recursive_boundary_;
+        for (int i = 0; i < N_RANK; ++i) {
+            thres.dx[i] = dx_recursive_[i];
+            thres.dx_boundary[i] = dx_recursive_boundary_[i];
+        }
+    }
     inline void push_queue(int dep, int level, int t0, int t1, grid_info<N_RANK> const & grid);
     inline queue_info & top_queue(int dep);
     inline void pop_queue(int dep);
@@ -475,6 +665,35 @@ struct Algorithm {
     template <typename F, typename BF>
     inline void shorter_duo_sim_obase_bicut_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf);
 
+    /* the same hyperspace cut, run as a dataflow graph (POCHOIR_DATAFLOW) */
+    inline void dataflow_cut(int level, int lt, grid_info<N_RANK> & grid, bool boundary, cut_info & cut);
+    template <typename G>
+    inline void dataflow_space_cut(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g);
+    template <typename G>
+    inline void dataflow_zoid(dataflow_info * df, int z, G const & g);
+    template <typename F>
+    inline void shorter_duo_sim_obase_dataflow(int t0, int t1, grid_info<N_RANK> const grid, F const & f);
+    template <typename F, typename BF>
+    inline void shorter_duo_sim_obase_dataflow_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf);
+
+    /* the dimensions of slope 0 cut flat on top of the recursion */
+    inline int flat_slabs(grid_info<N_RANK> const & grid, int * n) const;
+    template <typename G>
+    inline void flat_cut(int t0, int t1, grid_info<N_RANK> const grid, G const & g);
+
+    /* one slab per NUMA node on top of the recursion (POCHOIR_NUMA) */
+    template <typename G>
+    inline void numa_slab_cut(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g);
+
+    /* diamond tiling, POCHOIR_WALK_DIAMOND (pochoir_walk_diamond.hpp) */
+    inline void diamond_cut(int level, int lt, grid_info<N_RANK> const & grid, bool boundary, diamond_info & cut);
+    template <typename G>
+    inline void diamond_band(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g);
+    template <typename F>
+    inline void diamond_tile(int t0, int t1, grid_info<N_RANK> const grid, F const & f);
+    template <typename F, typename BF>
+    inline void diamond_tile_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf);
+
     /* followings are the sim cut of both top and bottom bar */
     template <typename F>
     inline void duo_sim_obase_space_cut(int t0, int t1, grid_info<N_RANK> const grid, F const & f);
@@ -556,9 +775,9 @@ void Algorithm<N_RANK>::set_phys_grid(grid_info<N_RANK> const & grid)
     if (slopeSet) {
         /* set up the lb/ub_boundary */
         for (int i = 0; i < N_RANK; ++i) {
-            ulb_boundary[i] = phys_grid_.x1[i] - slope_[i];
-            uub_boundary[i] = phys_grid_.x1[i] + slope_[i];
-            lub_boundary[i] = phys_grid_.x0[i] + slope_[i];
+            ulb_boundary[i] = phys_grid_.x1[i] - slope1_[i];
+            uub_boundary[i] = phys_grid_.x1[i] + slope0_[i];
+            lub_boundary[i] = phys_grid_.x0[i] + slope0_[i];
         }
     }
 }
@@ -567,14 +786,14 @@ template <int N_RANK>
 void Algorithm<N_RANK>::set_slope(int const slope[])
 {
     for (int i = 0; i < N_RANK; ++i)
-        slope_[i] = slope[i];
+        slope_[i] = slope0_[i] = slope1_[i] = slope[i];
     slopeSet = true;
     if (physGridSet) {
         /* set up the lb/ub_boundary */
         for (int i = 0; i < N_RANK; ++i) {
-            ulb_boundary[i] = phys_grid_.x1[i] - slope_[i];
-            uub_boundary[i] = phys_grid_.x1[i] + slope_[i];
-            lub_boundary[i] = phys_grid_.x0[i] + slope_[i];
+            ulb_boundary[i] = phys_grid_.x1[i] - slope1_[i];
+            uub_boundary[i] = phys_grid_.x1[i] + slope0_[i];
+            lub_boundary[i] = phys_grid_.x0[i] + slope0_[i];
         }
     }
 }
@@ -0,0 +1,173 @@
+/*
+ **********************************************************************************
+ *  Copyright (C) 2010-2011  Massachusetts Institute of Technology
+ *  Copyright (C) 2010-2011  Yuan Tang <yuantang@csail.mit.edu>
+ *                           Charles E. Leiserson <cel@mit.edu>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Suggestsions:                  yuantang@csail.mit.edu
+ *   Bugs:                          yuantang@csail.mit.edu
+ *
+ *********************************************************************************
+ */
+
+#ifndef POCHOIR_WALK_DIAMOND_HPP
+#define POCHOIR_WALK_DIAMOND_HPP
+
+#include "pochoir_common.hpp"
+#include "pochoir_walk.hpp"
+
+/* Diamond tiling (POCHOIR_WALK_DIAMOND) : a cache-aware alternative to the
+ * trapezoidal decomposition. The time is cut into bands of dt_recursive_
+ * steps. In a band, dimension i is cut into upright trapezoids
+ * (dx0 = slope, dx1 = -slope) of dx_recursive_[i] + 2 * slope_[i] * lt
+ * at the bottom, and the inverted trapezoids (dx0 = -slope, dx1 = slope)
+ * growing in the gaps between them. The inverted tile of one band and the
+ * upright tile right on top of it in the next band make up a diamond.
+ *
+ * A tile which is inverted on k dimensions only waits for the tiles
+ * inverted on k-1 of them, so a band runs in N_RANK+1 waves of independent
+ * tiles, and all the upright tiles of the band start at once, with no
+ * pipeline to fill. The tile sizes are fixed by the stopping sizes of
+ * set_thres() (sized to a cache level) and the slopes, not by recursion.
+ */
+
+/* cut dimension 'level' of a band of height 'lt' */
+template <int N_RANK>
+inline void Algorithm<N_RANK>::diamond_cut(int level, int lt, grid_info<N_RANK> const & grid, bool boundary, diamond_info & cut)
+{
+    const int lb = grid.x1[level] - grid.x0[level];
+    cut.x0 = grid.x0[level]; cut.dx0 = grid.dx0[level];
+    cut.x1 = grid.x1[level]; cut.dx1 = grid.dx1[level];
+    cut.w = dx_recursive_[level] + 2 * slope_[level] * lt;
+    cut.n_up = max(1, lb / cut.w);
+    /* on a periodic dimension, the last gap is across x1, i.e. between
+     * the last and the first tile
+     */
+    cut.wrap = (boundary && slope_[level] > 0 && lb >= cut.w
+             && lb == phys_length_[level] && grid.dx0[level] == 0 && grid.dx1[level] == 0);
+    /* with a zero slope, the tiles are boxes without gaps */
+    cut.n_gap = (slope_[level] == 0) ? 0 : (cut.wrap ? cut.n_up : cut.n_up - 1);
+}
+
+/* run one band [t0, t1) of diamond tiles, wave by wave;
+ * 'g' runs one tile : g(t0, t1, grid)
+ */
+template <int N_RANK> template <typename G>
+inline void Algorithm<N_RANK>::diamond_band(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g)
+{
+    diamond_info l_cut[N_RANK];
+    /* the kinds of tile in a wave, by the dimensions they are inverted
+     * on, and where their tiles start in the flat index of the wave
+     */
+    int l_mask[1 << N_RANK], l_first[(1 << N_RANK) + 1];
+
+    for (int i = 0; i < N_RANK; ++i)
+        diamond_cut(i, t1 - t0, grid, boundary, l_cut[i]);
+    for (int l_wave = 0; l_wave <= N_RANK; ++l_wave) {
+        int l_kinds = 0;
+        l_first[0] = 0;
+        for (int m = 0; m < (1 << N_RANK); ++m) {
+            if (__builtin_popcount(m) != l_wave)
+                continue;
+            int l_tiles = 1;
+            for (int i = 0; i < N_RANK; ++i)
+                l_tiles *= ((m >> i) & 1) ? l_cut[i].n_gap : l_cut[i].n_up;
+            if (l_tiles == 0)
+                continue;
+            l_mask[l_kinds] = m;
+            l_first[l_kinds+1] = l_first[l_kinds] + l_tiles;
+            ++l_kinds;
+        }
+        if (l_kinds == 0)
+            continue;
+        pochoir_for (k, 0, l_first[l_kinds]) {
+            int l_kind = 0;
+            while (k >= l_first[l_kind+1])
+                ++l_kind;
+            const int m = l_mask[l_kind];
+            int z = k - l_first[l_kind];
+            grid_info<N_RANK> l_grid;
+            for (int i = 0; i < N_RANK; ++i) {
+                const diamond_info & l_c = l_cut[i];
+                const int s = slope_[i];
+                if ((m >> i) & 1) {
+                    /* inverted, growing from the j+1-th cut point */
+                    const int j = z % l_c.n_gap;
+                    z /= l_c.n_gap;
+                    const int l_x = (j + 1 < l_c.n_up) ? l_c.x0 + (j + 1) * l_c.w : l_c.x1;
+                    l_grid.x0[i] = l_x; l_grid.dx0[i] = -s;
+                    l_grid.x1[i] = l_x; l_grid.dx1[i] = s;
+                } else {
+                    /* upright, the outer sides keep the slopes of 'grid' */
+                    const int j = z % l_c.n_up;
+                    z /= l_c.n_up;
+                    const bool l_last = (j == l_c.n_up - 1);
+                    l_grid.x0[i] = l_c.x0 + j * l_c.w;
+                    l_grid.dx0[i] = (j == 0 && !l_c.wrap) ? l_c.dx0 : s;
+                    l_grid.x1[i] = l_last ? l_c.x1 : l_c.x0 + (j + 1) * l_c.w;
+                    l_grid.dx1[i] = (l_last && !l_c.wrap) ? l_c.dx1 : -s;
+                }
+            }
+            g(t0, t1, l_grid);
+        } pochoir_for_end;
+    }
+}
+
+/* obase for zero-padded region */
+template <int N_RANK> template <typename F>
+inline void Algorithm<N_RANK>::diamond_tile(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
+{
+    grid_info<N_RANK> l_grid = grid;
+    for (int t = t0; t < t1; t += dt_recursive_) {
+        const int l_t1 = min(t + dt_recursive_, t1);
+        diamond_band(t, l_t1, l_grid, false, [&](int _t0, int _t1, grid_info<N_RANK> const & _grid) {
+            f(_t0, _t1, _grid);
+        });
+        for (int i = 0; i < N_RANK; ++i) {
+            l_grid.x0[i] += l_grid.dx0[i] * (l_t1 - t);
+            l_grid.x1[i] += l_grid.dx1[i] * (l_t1 - t);
+        }
+    }
+}
+
+/* obase for interior and ExecSpec for boundary : the tiles within a
+ * slope of the boundary (or across it) run 'bf'
+ */
+template <int N_RANK> template <typename F, typename BF>
+inline void Algorithm<N_RANK>::diamond_tile_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
+{
+    grid_info<N_RANK> l_grid = grid;
+    for (int t = t0; t < t1; t += dt_recursive_) {
+        const int l_t1 = min(t + dt_recursive_, t1);
+        diamond_band(t, l_t1, l_grid, true, [&](int _t0, int _t1, grid_info<N_RANK> const & _grid) {
+            grid_info<N_RANK> l_tile = _grid;
+            bool l_boundary = false;
+            /* l_tile may be mapped to a new region in touch_boundary() */
+            for (int i = 0; i < N_RANK; ++i)
+                l_boundary |= touch_boundary(i, _t1 - _t0, l_tile);
+            if (l_boundary)
+                base_case_kernel_boundary(_t0, _t1, l_tile, bf);
+            else
+                f(_t0, _t1, l_tile);
+        });
+        for (int i = 0; i < N_RANK; ++i) {
+            l_grid.x0[i] += l_grid.dx0[i] * (l_t1 - t);
+            l_grid.x1[i] += l_grid.dx1[i] * (l_t1 - t);
+        }
+    }
+}
+
+#endif /* POCHOIR_WALK_DIAMOND_HPP */
@@ -29,8 +29,6 @@
 #include <cstdio>
 #include <cassert>
 #include <iostream>
-#include <cilk/cilk.h>
-#include <cilk/cilk_api.h>
 #include "pochoir_common.hpp"
 
 using namespace std;
@@ -122,7 +120,7 @@ struct meta_grid_interior <1, F>{
 static inline void set_worker_count(const char * nstr) 
 {
 #if 1
-    if (0 != __cilkrts_set_param("nworkers", nstr)) {
+    if (0 != pochoir_set_nworkers(nstr)) {
         printf("Failed to set worker count\n");
     } else {
         printf("Successfully set worker count to %s\n", nstr);
@@ -187,7 +185,7 @@ struct Algorithm {
 #if DEBUG
         N_CORES = 2;
 #else
-        N_CORES = __cilkrts_get_nworkers();
+        N_CORES = pochoir_get_nworkers();
 #endif
 //        cout << " N_CORES = " << N_CORES << endl;
 
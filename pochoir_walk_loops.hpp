@@ -33,6 +33,7 @@
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::naive_cut_space_mp(int dim, int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
 	/* This is the version that cut into as many pieces as we can */
 	/* cut into Space dimension one after another */
 	int i;
@@ -69,35 +70,35 @@ inline void Algorithm<N_RANK>::naive_cut_space_mp(int dim, int t0, int t1, grid_
 			l_grid.dx0[dim] = slope_[dim];
 			l_grid.x1[dim] = grid.x0[dim] + (i + 1) * sep;
 			l_grid.dx1[dim] = -slope_[dim];
-			cilk_spawn naive_cut_space_mp(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_mp(dim+1, t0, t1, l_grid, f));
 		}
 		l_grid.x0[dim] = grid.x0[dim] + i * sep;
 		l_grid.dx0[dim] = slope_[dim];
 		l_grid.x1[dim] = grid.x1[dim];
 		l_grid.dx1[dim] = -slope_[dim];
 		naive_cut_space_mp(dim+1, t0, t1, l_grid, f);
-		cilk_sync;
+		pochoir_sync;
 
 		if (grid.dx0[dim] != slope_[dim]) {
 			l_grid.x0[dim] = grid.x0[dim];
 			l_grid.dx0[dim] = grid.dx0[dim];
 			l_grid.x1[dim] = grid.x0[dim];
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn naive_cut_space_mp(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_mp(dim+1, t0, t1, l_grid, f));
 		}
 		for (i = 1; i < r; i++) {
 			l_grid.x0[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn naive_cut_space_mp(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_mp(dim+1, t0, t1, l_grid, f));
 		}
 		if (grid.dx1[dim] != -slope_[dim]) {
 			l_grid.x0[dim] = grid.x1[dim];
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x1[dim];
 			l_grid.dx1[dim] = grid.dx1[dim];
-			cilk_spawn naive_cut_space_mp(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_mp(dim+1, t0, t1, l_grid, f));
 		}
 		return;
 	}
@@ -106,6 +107,7 @@ inline void Algorithm<N_RANK>::naive_cut_space_mp(int dim, int t0, int t1, grid_
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::naive_cut_space_ncores(int dim, int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
 	/* This version cut into exactly N_CORES pieces */
 	/* cut into Space dimension one after another */
 	int i;
@@ -140,7 +142,7 @@ inline void Algorithm<N_RANK>::naive_cut_space_ncores(int dim, int t0, int t1, g
 			l_grid.dx0[dim] = slope_[dim];
 			l_grid.x1[dim] = grid.x0[dim] + (i + 1) * sep;
 			l_grid.dx1[dim] = -slope_[dim];
-			cilk_spawn naive_cut_space_ncores(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_ncores(dim+1, t0, t1, l_grid, f));
 		}
 		l_grid.x0[dim] = grid.x0[dim] + i * sep;
 		l_grid.dx0[dim] = slope_[dim];
@@ -151,28 +153,28 @@ inline void Algorithm<N_RANK>::naive_cut_space_ncores(int dim, int t0, int t1, g
 //		fprintf(stdout, "cilk_sync\n");
 //		fflush(stdout);
 #endif
-		cilk_sync;
+		pochoir_sync;
 
 		if (grid.dx0[dim] != slope_[dim]) {
 			l_grid.x0[dim] = grid.x0[dim];
 			l_grid.dx0[dim] = grid.dx0[dim];
 			l_grid.x1[dim] = grid.x0[dim];
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn naive_cut_space_ncores(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_ncores(dim+1, t0, t1, l_grid, f));
 		}
 		for (i = 1; i < N_CORES; i++) {
 			l_grid.x0[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn naive_cut_space_ncores(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_ncores(dim+1, t0, t1, l_grid, f));
 		}
 		if (grid.dx1[dim] != -slope_[dim]) {
 			l_grid.x0[dim] = grid.x1[dim];
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x1[dim];
 			l_grid.dx1[dim] = grid.dx1[dim];
-			cilk_spawn naive_cut_space_ncores(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(naive_cut_space_ncores(dim+1, t0, t1, l_grid, f));
 		}
 		return;
 	}
@@ -181,6 +183,7 @@ inline void Algorithm<N_RANK>::naive_cut_space_ncores(int dim, int t0, int t1, g
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::cut_space_ncores_boundary(int dim, int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
 	/* This version cut into exactly NCORES pieces */
 	/* cut into Space dimension one after another */
 	int i;
@@ -209,7 +212,7 @@ inline void Algorithm<N_RANK>::cut_space_ncores_boundary(int dim, int t0, int t1
 #endif
 			call_boundary = false;
 			for (int i = 0; i < N_RANK; i++) {
-				call_boundary |= (grid.x0[i] == initial_grid_.x0[i] || grid.x1[i] == initial_grid_.x1[i]);
+				call_boundary |= (grid.x0[i] == phys_grid_.x0[i] || grid.x1[i] == phys_grid_.x1[i]);
 			}
 			if (call_boundary) 
                 //we will defer the processing of boundary condition later
@@ -230,7 +233,7 @@ inline void Algorithm<N_RANK>::cut_space_ncores_boundary(int dim, int t0, int t1
 			l_grid.dx0[dim] = slope_[dim];
 			l_grid.x1[dim] = l_start + (i + 1) * sep;
 			l_grid.dx1[dim] = -slope_[dim];
-			cilk_spawn cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f));
 		}
 		l_grid.x0[dim] = l_start + i * sep;
 		l_grid.dx0[dim] = slope_[dim];
@@ -241,28 +244,28 @@ inline void Algorithm<N_RANK>::cut_space_ncores_boundary(int dim, int t0, int t1
 //		fprintf(stdout, "cilk_sync\n");
 //		fflush(stdout);
 #endif
-		cilk_sync;
+		pochoir_sync;
 
 		if (grid.dx0[dim] != slope_[dim]) {
 			l_grid.x0[dim] = grid.x0[dim];
 			l_grid.dx0[dim] = grid.dx0[dim];
 			l_grid.x1[dim] = grid.x0[dim];
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f));
 		}
 		for (i = 1; i < N_CORES; i++) {
 			l_grid.x0[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x0[dim] + i * sep;
 			l_grid.dx1[dim] = slope_[dim];
-			cilk_spawn cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f));
 		}
 		if (grid.dx1[dim] != -slope_[dim]) {
 			l_grid.x0[dim] = grid.x1[dim];
 			l_grid.dx0[dim] = -slope_[dim];
 			l_grid.x1[dim] = grid.x1[dim];
 			l_grid.dx1[dim] = grid.dx1[dim];
-			cilk_spawn cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f);
+			pochoir_spawn(cut_space_ncores_boundary(dim+1, t0, t1, l_grid, f));
 		}
 
 		return;
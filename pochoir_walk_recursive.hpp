@@ -30,7 +30,7 @@
 #include "pochoir_walk.hpp"
 
 #define initial_cut(i) (lb[i] == phys_length_[i])
-/* grid.x1[i] >= phys_grid_.x1[i] - stride_[i] - slope_[i] 
+/* grid.x1[i] >= phys_grid_.x1[i] - stride_[i] - slope1_[i] 
  * because we compute the kernel with range [a, b)
  */
 template <int N_RANK>
@@ -161,6 +161,7 @@ inline void Algorithm<N_RANK>::walk_serial(int t0, int t1, grid_info<N_RANK> con
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::walk_bicut(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+	pochoir_task_frame;
 	/* for the initial cut on each dimension, cut into exact N_CORES pieces,
 	   for the rest cut into that dimension, cut into as many as we can!
 	 */
@@ -170,7 +171,7 @@ inline void Algorithm<N_RANK>::walk_bicut(int t0, int t1, grid_info<N_RANK> cons
 
 	for (int i = 0; i < N_RANK; ++i) {
 		lb[i] = grid.x1[i] - grid.x0[i];
-		thres[i] = 2 * (2 * slope_[i] * lt);
+		thres[i] = 2 * (slope0_[i] + slope1_[i]) * lt;
 	}	
 
 	for (int i = N_RANK-1; i >= 0; --i) {
@@ -181,36 +182,36 @@ inline void Algorithm<N_RANK>::walk_bicut(int t0, int t1, grid_info<N_RANK> cons
 //			printf("initial_cut = %s, lb[%d] = %d, sep = %d, r = %d\n", initial_cut(i) ? "True" : "False", i, lb[i], sep, r);
 #endif
 			l_grid.x0[i] = grid.x0[i];
-			l_grid.dx0[i] = slope_[i];
+			l_grid.dx0[i] = slope0_[i];
 			l_grid.x1[i] = grid.x0[i] + sep;
-			l_grid.dx1[i] = -slope_[i];
-			cilk_spawn walk_bicut(t0, t1, l_grid, f);
+			l_grid.dx1[i] = -slope1_[i];
+			pochoir_spawn(walk_bicut(t0, t1, l_grid, f));
 
 			l_grid.x0[i] = grid.x0[i] + sep;
-			l_grid.dx0[i] = slope_[i];
+			l_grid.dx0[i] = slope0_[i];
 			l_grid.x1[i] = grid.x1[i];
-			l_grid.dx1[i] = -slope_[i];
-			cilk_spawn walk_bicut(t0, t1, l_grid, f);
+			l_grid.dx1[i] = -slope1_[i];
+			pochoir_spawn(walk_bicut(t0, t1, l_grid, f));
 #if DEBUG
 //			print_sync(stdout);
 #endif
-			cilk_sync;
-			if (grid.dx0[i] != slope_[i]) {
+			pochoir_sync;
+			if (grid.dx0[i] != slope0_[i]) {
 				l_grid.x0[i] = grid.x0[i]; l_grid.dx0[i] = grid.dx0[i];
-				l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope_[i];
-				cilk_spawn walk_bicut(t0, t1, l_grid, f);
+				l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope0_[i];
+				pochoir_spawn(walk_bicut(t0, t1, l_grid, f));
 			}
 
 			l_grid.x0[i] = grid.x0[i] + sep;
-			l_grid.dx0[i] = -slope_[i];
+			l_grid.dx0[i] = -slope1_[i];
 			l_grid.x1[i] = grid.x0[i] + sep;
-			l_grid.dx1[i] = slope_[i];
-			cilk_spawn walk_bicut(t0, t1, l_grid, f);
+			l_grid.dx1[i] = slope0_[i];
+			pochoir_spawn(walk_bicut(t0, t1, l_grid, f));
 
-			if (grid.dx1[i] != -slope_[i]) {
-				l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope_[i];
+			if (grid.dx1[i] != -slope1_[i]) {
+				l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope1_[i];
 				l_grid.x1[i] = grid.x1[i]; l_grid.dx1[i] = grid.dx1[i];
-				cilk_spawn walk_bicut(t0, t1, l_grid, f);
+				pochoir_spawn(walk_bicut(t0, t1, l_grid, f));
 			}
 #if DEBUG
 			printf("%s:%d cut into %d dim\n", __FUNCTION__, __LINE__, i);
@@ -278,6 +279,7 @@ do { \
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -297,13 +299,13 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     shorter_duo_sim_obase_bicut(l_son->t0, l_son->t1, l_son->grid, f);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -311,8 +313,12 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                 pop_queue(curr_dep_pointer);
                 if (queue_len_[curr_dep_pointer] == 0)
                     shorter_duo_sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
-                else
-                    cilk_spawn shorter_duo_sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
+                else {
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(shorter_duo_sim_obase_bicut(l_t0, l_t1, l_son_grid, f));
+                }
 #endif
             } else {
                 /* performing a space cut on dimension 'level' */
@@ -321,11 +327,11 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                 const int t0 = l_father->t0, t1 = l_father->t1;
                 const int lt = (t1 - t0);
                 const int level = l_father->level;
-                const int thres = slope_[level] * lt;
+                const int thres0 = slope0_[level] * lt, thres1 = slope1_[level] * lt;
                 const int lb = (l_father_grid.x1[level] - l_father_grid.x0[level]);
                 const int tb = (l_father_grid.x1[level] + l_father_grid.dx1[level] * lt - l_father_grid.x0[level] - l_father_grid.dx0[level] * lt);
                 const bool cut_lb = (lb < tb);
-                const bool can_cut = cut_lb ? (lb >= 2 * thres && lb > dx_recursive_[level]) : (tb >= 2 * thres && lb > dx_recursive_[level]);
+                const bool can_cut = cut_lb ? (lb >= thres0 + thres1 && lb > dx_recursive_[level]) : (tb >= thres0 + thres1 && lb > dx_recursive_[level]);
                 if (!can_cut) {
                     /* if we can't cut into this dimension, just directly push 
                      * it into the circular queue 
@@ -334,18 +340,19 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                 } else {
                     /* can_cut! */
                     if (cut_lb) {
-                        const int mid = (lb/2);
                         grid_info<N_RANK> l_son_grid = l_father_grid;
                         const int l_start = (l_father_grid.x0[level]);
                         const int l_end = (l_father_grid.x1[level]);
+                        /* the gray minizoid is thres0 + thres1 wide at the bottom */
+                        const int l_gray = l_start + (lb - thres0 - thres1) / 2;
 
                         /* push the middle triangular minizoid (gray) into 
                          * circular queue of (curr_dep) 
                          */
-                        l_son_grid.x0[level] = l_start + mid - thres;
-                        l_son_grid.dx0[level] = slope_[level];
-                        l_son_grid.x1[level] = l_start + mid + thres;
-                        l_son_grid.dx1[level] = -slope_[level];
+                        l_son_grid.x0[level] = l_gray;
+                        l_son_grid.dx0[level] = slope0_[level];
+                        l_son_grid.x1[level] = l_gray + thres0 + thres1;
+                        l_son_grid.dx1[level] = -slope1_[level];
                         push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
 
                         /* cilk_sync */
@@ -355,15 +362,15 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                          */
                         l_son_grid.x0[level] = l_start;
                         l_son_grid.dx0[level] = l_father_grid.dx0[level];
-                        l_son_grid.x1[level] = l_start + mid - thres;
-                        l_son_grid.dx1[level] = slope_[level];
+                        l_son_grid.x1[level] = l_gray;
+                        l_son_grid.dx1[level] = slope0_[level];
                         push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
 
                         /* push the right big trapezoid (black)
                          * into circular queue of (curr_dep + 1)
                          */
-                        l_son_grid.x0[level] = l_start + mid + thres;
-                        l_son_grid.dx0[level] = -slope_[level];
+                        l_son_grid.x0[level] = l_gray + thres0 + thres1;
+                        l_son_grid.dx0[level] = -slope1_[level];
                         l_son_grid.x1[level] = l_end;
                         l_son_grid.dx1[level] = l_father_grid.dx1[level];
                         push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
@@ -371,22 +378,25 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                     } /* end if (cut_lb) */
                     else {
                         /* cut_tb */
-                        const int mid = (tb/2);
                         grid_info<N_RANK> l_son_grid = l_father_grid;
                         const int l_start = (l_father_grid.x0[level]);
                         const int l_end = (l_father_grid.x1[level]);
                         const int ul_start = (l_father_grid.x0[level] + l_father_grid.dx0[level] * lt);
+                        /* the gray minizoid grows from l_gray, the black 
+                         * ones are at least thres1 and thres0 wide at the top
+                         */
+                        const int l_gray = ul_start + thres1 + (tb - thres0 - thres1) / 2;
 
                         /* push left black sub-grid into circular queue of (curr_dep) */
                         l_son_grid.x0[level] = l_start;
                         l_son_grid.dx0[level] = l_father_grid.dx0[level];
-                        l_son_grid.x1[level] = ul_start + mid;
-                        l_son_grid.dx1[level] = -slope_[level];
+                        l_son_grid.x1[level] = l_gray;
+                        l_son_grid.dx1[level] = -slope1_[level];
                         push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
 
                         /* push right black sub-grid into circular queue of (curr_dep) */
-                        l_son_grid.x0[level] = ul_start + mid;;
-                        l_son_grid.dx0[level] = slope_[level];
+                        l_son_grid.x0[level] = l_gray;
+                        l_son_grid.dx0[level] = slope0_[level];
                         l_son_grid.x1[level] = l_end;
                         l_son_grid.dx1[level] = l_father_grid.dx1[level];
                         push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
@@ -396,17 +406,17 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
                         /* push the middle gray triangular minizoid into 
                          * circular queue of (curr_dep + 1)
                          */
-                        l_son_grid.x0[level] = ul_start + mid;
-                        l_son_grid.dx0[level] = -slope_[level];
-                        l_son_grid.x1[level] = ul_start + mid;
-                        l_son_grid.dx1[level] = slope_[level];
+                        l_son_grid.x0[level] = l_gray;
+                        l_son_grid.dx0[level] = -slope1_[level];
+                        l_son_grid.x1[level] = l_gray;
+                        l_son_grid.dx1[level] = slope0_[level];
                         push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
                     } /* end else (cut_tb) */
                 } /* end if (can_cut) */
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
@@ -417,6 +427,7 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut(int t0, int t1, g
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -436,13 +447,13 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     shorter_duo_sim_obase_bicut_p(l_son->t0, l_son->t1, l_son->grid, f, bf);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -451,7 +462,10 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                 if (queue_len_[curr_dep_pointer] == 0) {
                     shorter_duo_sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
                 } else {
-                    cilk_spawn shorter_duo_sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(shorter_duo_sim_obase_bicut_p(l_t0, l_t1, l_son_grid, f, bf));
                 }
 #endif
             } else {
@@ -461,12 +475,12 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                 const int t0 = l_father->t0, t1 = l_father->t1;
                 const int lt = (t1 - t0);
                 const int level = l_father->level;
-                const int thres = slope_[level] * lt;
+                const int thres0 = slope0_[level] * lt, thres1 = slope1_[level] * lt;
                 const int lb = (l_father_grid.x1[level] - l_father_grid.x0[level]);
                 const int tb = (l_father_grid.x1[level] + l_father_grid.dx1[level] * lt - l_father_grid.x0[level] - l_father_grid.dx0[level] * lt);
                 const bool cut_lb = (lb < tb);
                 const bool l_touch_boundary = touch_boundary(level, lt, l_father_grid);
-                const bool can_cut = cut_lb ? (l_touch_boundary ? (lb >= 2 * thres && lb > dx_recursive_boundary_[level]) : (lb >= 2 * thres && lb > dx_recursive_[level])) : (l_touch_boundary ? (tb >= 2 * thres && lb > dx_recursive_boundary_[level]) : (tb >= 2 * thres && lb > dx_recursive_[level]));
+                const bool can_cut = cut_lb ? (l_touch_boundary ? (lb >= thres0 + thres1 && lb > dx_recursive_boundary_[level]) : (lb >= thres0 + thres1 && lb > dx_recursive_[level])) : (l_touch_boundary ? (tb >= thres0 + thres1 && lb > dx_recursive_boundary_[level]) : (tb >= thres0 + thres1 && lb > dx_recursive_[level]));
                 if (!can_cut) {
                     /* if we can't cut into this dimension, just directly push
                      * it into the circular queue
@@ -477,18 +491,19 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                     if (cut_lb) {
                         /* if cutting lb, there's no initial cut! */
                         assert(lb != phys_length_[level] || l_father_grid.dx0[level] != 0 || l_father_grid.dx1[level] != 0);
-                        const int mid = lb/2;
                         grid_info<N_RANK> l_son_grid = l_father_grid;
                         const int l_start = (l_father_grid.x0[level]);
                         const int l_end = (l_father_grid.x1[level]);
+                        /* the gray minizoid is thres0 + thres1 wide at the bottom */
+                        const int l_gray = l_start + (lb - thres0 - thres1) / 2;
 
                         /* push the middle gray minizoid
                          * into circular queue of (curr_dep) 
                          */
-                        l_son_grid.x0[level] = l_start + mid - thres;
-                        l_son_grid.dx0[level] = slope_[level];
-                        l_son_grid.x1[level] = l_start + mid + thres;
-                        l_son_grid.dx1[level] = -slope_[level];
+                        l_son_grid.x0[level] = l_gray;
+                        l_son_grid.dx0[level] = slope0_[level];
+                        l_son_grid.x1[level] = l_gray + thres0 + thres1;
+                        l_son_grid.dx1[level] = -slope1_[level];
                         push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
 
                         /* cilk_sync */
@@ -496,13 +511,13 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                         /* push one sub-grid into circular queue of (curr_dep + 1)*/
                         l_son_grid.x0[level] = l_start;
                         l_son_grid.dx0[level] = l_father_grid.dx0[level];
-                        l_son_grid.x1[level] = l_start + mid - thres;
-                        l_son_grid.dx1[level] = slope_[level];
+                        l_son_grid.x1[level] = l_gray;
+                        l_son_grid.dx1[level] = slope0_[level];
                         push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
 
                         /* push one sub-grid into circular queue of (curr_dep + 1)*/
-                        l_son_grid.x0[level] = l_start + mid + thres;
-                        l_son_grid.dx0[level] = -slope_[level];
+                        l_son_grid.x0[level] = l_gray + thres0 + thres1;
+                        l_son_grid.dx0[level] = -slope1_[level];
                         l_son_grid.x1[level] = l_end;
                         l_son_grid.dx1[level] = l_father_grid.dx1[level];
                         push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
@@ -511,42 +526,42 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                         if (lb == phys_length_[level] && l_father_grid.dx0[level] == 0 && l_father_grid.dx1[level] == 0) { /* initial cut on the dimension */
                             assert(l_father_grid.dx0[level] == 0);
                             assert(l_father_grid.dx1[level] == 0);
-                            const int mid = tb/2;
                             grid_info<N_RANK> l_son_grid = l_father_grid;
                             const int l_start = (l_father_grid.x0[level]);
                             const int l_end = (l_father_grid.x1[level]);
                             const int ul_start = (l_father_grid.x0[level] + l_father_grid.dx0[level] * lt);
+                            const int l_gray = ul_start + thres1 + (tb - thres0 - thres1) / 2;
                             /* merge the big black trapezoids */
-                            l_son_grid.x0[level] = ul_start + mid;
-                            l_son_grid.dx0[level] = slope_[level];
-                            l_son_grid.x1[level] = l_end + (ul_start - l_start) + mid;
-                            l_son_grid.dx1[level] = -slope_[level];
+                            l_son_grid.x0[level] = l_gray;
+                            l_son_grid.dx0[level] = slope0_[level];
+                            l_son_grid.x1[level] = l_gray + lb;
+                            l_son_grid.dx1[level] = -slope1_[level];
                             push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
 
                             /* cilk_sync */
                             const int next_dep_pointer = (curr_dep + 1) & 0x1;
                             /* push middle minizoid into circular queue of (curr_dep + 1)*/
-                            l_son_grid.x0[level] = ul_start + mid;
-                            l_son_grid.dx0[level] = -slope_[level];
-                            l_son_grid.x1[level] = ul_start + mid;
-                            l_son_grid.dx1[level] = slope_[level];
+                            l_son_grid.x0[level] = l_gray;
+                            l_son_grid.dx0[level] = -slope1_[level];
+                            l_son_grid.x1[level] = l_gray;
+                            l_son_grid.dx1[level] = slope0_[level];
                             push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
                         } else { /* NOT the initial cut! */
-                            const int mid = tb/2;
                             grid_info<N_RANK> l_son_grid = l_father_grid;
                             const int l_start = (l_father_grid.x0[level]);
                             const int l_end = (l_father_grid.x1[level]);
                             const int ul_start = (l_father_grid.x0[level] + l_father_grid.dx0[level] * lt);
+                            const int l_gray = ul_start + thres1 + (tb - thres0 - thres1) / 2;
                             /* push one sub-grid into circular queue of (curr_dep) */
                             l_son_grid.x0[level] = l_start;
                             l_son_grid.dx0[level] = l_father_grid.dx0[level];
-                            l_son_grid.x1[level] = ul_start + mid;
-                            l_son_grid.dx1[level] = -slope_[level];
+                            l_son_grid.x1[level] = l_gray;
+                            l_son_grid.dx1[level] = -slope1_[level];
                             push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
 
                             /* push one sub-grid into circular queue of (curr_dep) */
-                            l_son_grid.x0[level] = ul_start + mid;
-                            l_son_grid.dx0[level] = slope_[level];
+                            l_son_grid.x0[level] = l_gray;
+                            l_son_grid.dx0[level] = slope0_[level];
                             l_son_grid.x1[level] = l_end;
                             l_son_grid.dx1[level] = l_father_grid.dx1[level];
                             push_queue(curr_dep_pointer, level-1, t0, t1, l_son_grid);
@@ -554,10 +569,10 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
                             /* cilk_sync */
                             const int next_dep_pointer = (curr_dep + 1) & 0x1;
                             /* push one sub-grid into circular queue of (curr_dep + 1)*/
-                            l_son_grid.x0[level] = ul_start + mid;
-                            l_son_grid.dx0[level] = -slope_[level];
-                            l_son_grid.x1[level] = ul_start + mid;
-                            l_son_grid.dx1[level] = slope_[level];
+                            l_son_grid.x0[level] = l_gray;
+                            l_son_grid.dx0[level] = -slope1_[level];
+                            l_son_grid.x1[level] = l_gray;
+                            l_son_grid.dx1[level] = slope0_[level];
                             push_queue(next_dep_pointer, level-1, t0, t1, l_son_grid);
                         }                    
                     } /* end if (cut_tb) */
@@ -565,16 +580,269 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_space_cut_p(int t0, int t1,
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
 }
 
+/* cut one dimension of a hyperspace cut for the dataflow walk, with the
+ * same decisions as shorter_duo_sim_obase_space_cut()/_p() 
+ */
+template <int N_RANK>
+inline void Algorithm<N_RANK>::dataflow_cut(int level, int lt, grid_info<N_RANK> & grid, bool boundary, cut_info & cut)
+{
+    const int thres0 = slope0_[level] * lt, thres1 = slope1_[level] * lt;
+    const int lb = (grid.x1[level] - grid.x0[level]);
+    const int tb = (grid.x1[level] + grid.dx1[level] * lt - grid.x0[level] - grid.dx0[level] * lt);
+    const bool cut_lb = (lb < tb);
+    /* grid may be mapped to a new region in touch_boundary() */
+    const bool l_touch_boundary = boundary && touch_boundary(level, lt, grid);
+    const int l_dx_stop = l_touch_boundary ? dx_recursive_boundary_[level] : dx_recursive_[level];
+    const bool can_cut = cut_lb ? (lb >= thres0 + thres1 && lb > l_dx_stop) : (tb >= thres0 + thres1 && lb > l_dx_stop);
+    const int l_start = grid.x0[level], l_end = grid.x1[level];
+
+#define set_piece(_i, _x0, _dx0, _x1, _dx1, _wait) \
+do { \
+    cut.x0[_i] = (_x0); cut.dx0[_i] = (_dx0); \
+    cut.x1[_i] = (_x1); cut.dx1[_i] = (_dx1); \
+    cut.wait[_i] = (_wait); \
+} while(0)
+
+    if (!can_cut) {
+        cut.n = 1;
+        set_piece(0, l_start, grid.dx0[level], l_end, grid.dx1[level], false);
+    } else if (cut_lb) {
+        /* black, gray, black : the black trapezoids wait for the gray */
+        const int l_gray = l_start + (lb - thres0 - thres1) / 2;
+        cut.n = 3;
+        set_piece(0, l_start, grid.dx0[level], l_gray, slope0_[level], true);
+        set_piece(1, l_gray, slope0_[level], l_gray + thres0 + thres1, -slope1_[level], false);
+        set_piece(2, l_gray + thres0 + thres1, -slope1_[level], l_end, grid.dx1[level], true);
+    } else {
+        const int ul_start = (grid.x0[level] + grid.dx0[level] * lt);
+        const int l_gray = ul_start + thres1 + (tb - thres0 - thres1) / 2;
+        if (boundary && lb == phys_length_[level] && grid.dx0[level] == 0 && grid.dx1[level] == 0) {
+            /* initial cut : the two black trapezoids are merged across
+             * the periodic boundary, and the gray waits for it 
+             */
+            cut.n = 2;
+            set_piece(0, l_gray, slope0_[level], l_gray + lb, -slope1_[level], false);
+            set_piece(1, l_gray, -slope1_[level], l_gray, slope0_[level], true);
+        } else {
+            /* black, gray, black : the gray waits for both blacks */
+            cut.n = 3;
+            set_piece(0, l_start, grid.dx0[level], l_gray, -slope1_[level], false);
+            set_piece(1, l_gray, -slope1_[level], l_gray, slope0_[level], true);
+            set_piece(2, l_gray, slope0_[level], l_end, grid.dx1[level], false);
+        }
+    }
+#undef set_piece
+}
+
+/* Dataflow version of the hyperspace cut : a sub-zoid depends only on the
+ * sub-zoids next to it on one dimension, so instead of a cilk_sync after
+ * each dependency level, every sub-zoid counts the neighbors it waits for
+ * and is spawned by the last of them to finish.
+ * 'g' walks one sub-zoid : g(t0, t1, grid)
+ */
+template <int N_RANK> template <typename G>
+inline void Algorithm<N_RANK>::dataflow_space_cut(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g)
+{
+    pochoir_task_frame;
+    dataflow_info l_df;
+    grid_info<N_RANK> l_father_grid = grid;
+    int l_src[power3<N_RANK>::value];
+    int l_total = 1, l_nsrc = 0;
+
+    l_df.t0 = t0; l_df.t1 = t1;
+    for (int i = N_RANK-1; i >= 0; --i) {
+        dataflow_cut(i, t1 - t0, l_father_grid, boundary, l_df.cut[i]);
+        l_df.stride[i] = l_total;
+        l_total *= l_df.cut[i].n;
+    }
+    for (int z = 0; z < l_total; ++z) {
+        int l_count = 0;
+        for (int i = 0; i < N_RANK; ++i) {
+            const cut_info & l_cut = l_df.cut[i];
+            const int p = (z / l_df.stride[i]) % l_cut.n;
+            if (l_cut.wait[p])
+                l_count += (p > 0 && !l_cut.wait[p-1]) + (p < l_cut.n-1 && !l_cut.wait[p+1]);
+        }
+        l_df.count[z].store(l_count, std::memory_order_relaxed);
+        if (l_count == 0)
+            l_src[l_nsrc++] = z;
+    }
+    /* start the sub-zoids that wait for no one, the last one in place */
+    dataflow_info * l_pdf = &l_df;
+    for (int i = 0; i < l_nsrc-1; ++i) {
+        const int l_son = l_src[i];
+        pochoir_spawn(dataflow_zoid(l_pdf, l_son, g));
+    }
+    dataflow_zoid(l_pdf, l_src[l_nsrc-1], g);
+    pochoir_sync;
+}
+
+template <int N_RANK> template <typename G>
+inline void Algorithm<N_RANK>::dataflow_zoid(dataflow_info * df, int z, G const & g)
+{
+    pochoir_task_frame;
+    grid_info<N_RANK> l_grid;
+    int l_last = -1;
+
+    for (int i = 0; i < N_RANK; ++i) {
+        const cut_info & l_cut = df->cut[i];
+        const int p = (z / df->stride[i]) % l_cut.n;
+        l_grid.x0[i] = l_cut.x0[p]; l_grid.dx0[i] = l_cut.dx0[p];
+        l_grid.x1[i] = l_cut.x1[p]; l_grid.dx1[i] = l_cut.dx1[p];
+    }
+    g(df->t0, df->t1, l_grid);
+
+    /* release the neighbors waiting for this sub-zoid */
+    for (int i = 0; i < N_RANK; ++i) {
+        const cut_info & l_cut = df->cut[i];
+        const int p = (z / df->stride[i]) % l_cut.n;
+        if (l_cut.wait[p])
+            continue;
+        for (int q = p-1; q <= p+1; q += 2) {
+            if (q < 0 || q >= l_cut.n || !l_cut.wait[q])
+                continue;
+            const int l_son = z + (q - p) * df->stride[i];
+            if (df->count[l_son].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+            if (l_last >= 0)
+                pochoir_spawn(dataflow_zoid(df, l_last, g));
+            l_last = l_son;
+        }
+    }
+    if (l_last >= 0)
+        dataflow_zoid(df, l_last, g);
+    pochoir_sync;
+}
+
+template <int N_RANK> template <typename F>
+inline void Algorithm<N_RANK>::shorter_duo_sim_obase_dataflow(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
+{
+    dataflow_space_cut(t0, t1, grid, false, [&](int _t0, int _t1, grid_info<N_RANK> const & _grid) {
+        shorter_duo_sim_obase_bicut(_t0, _t1, _grid, f);
+    });
+}
+
+template <int N_RANK> template <typename F, typename BF>
+inline void Algorithm<N_RANK>::shorter_duo_sim_obase_dataflow_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
+{
+    dataflow_space_cut(t0, t1, grid, true, [&](int _t0, int _t1, grid_info<N_RANK> const & _grid) {
+        shorter_duo_sim_obase_bicut_p(_t0, _t1, _grid, f, bf);
+    });
+}
+
+/* a dimension of slope 0 (a batch or species index) has no dependencies
+ * at all, so it is cut into n[i] slabs no wider than dx_recursive_[i], 
+ * and the number of slabs returned
+ */
+template <int N_RANK>
+inline int Algorithm<N_RANK>::flat_slabs(grid_info<N_RANK> const & grid, int * n) const
+{
+    int l_slabs = 1;
+    for (int i = 0; i < N_RANK; ++i) {
+        const int lb = grid.x1[i] - grid.x0[i];
+        n[i] = 1;
+        if (slope_[i] == 0 && grid.dx0[i] == 0 && grid.dx1[i] == 0 && lb > dx_recursive_[i])
+            n[i] = (lb + dx_recursive_[i] - 1) / dx_recursive_[i];
+        l_slabs *= n[i];
+    }
+    return l_slabs;
+}
+
+/* the slabs of flat_slabs() in one flat parallel loop, 'g' walks each of
+ * them over [t0, t1) : g(t0, t1, grid). The recursion of 'g' finds the 
+ * dimensions of slope 0 no wider than their dx stop, so it never cuts 
+ * them, and they never hold back a time cut of the other dimensions
+ */
+template <int N_RANK> template <typename G>
+inline void Algorithm<N_RANK>::flat_cut(int t0, int t1, grid_info<N_RANK> const grid, G const & g)
+{
+    int l_n[N_RANK];
+    const int l_slabs = flat_slabs(grid, l_n);
+
+    if (l_slabs == 1) {
+        g(t0, t1, grid);
+        return;
+    }
+    pochoir_for (k, 0, l_slabs) {
+        grid_info<N_RANK> l_grid = grid;
+        int z = k;
+        for (int i = 0; i < N_RANK; ++i) {
+            if (l_n[i] == 1)
+                continue;
+            const int j = z % l_n[i];
+            const long lb = grid.x1[i] - grid.x0[i];
+            z /= l_n[i];
+            l_grid.x0[i] = grid.x0[i] + (int)(lb * j / l_n[i]);
+            l_grid.x1[i] = grid.x0[i] + (int)(lb * (j + 1) / l_n[i]);
+        }
+        g(t0, t1, l_grid);
+    } pochoir_for_end;
+}
+
+/* NUMA hybrid decomposition (POCHOIR_NUMA) : the highest spatial 
+ * dimension is split into one slab per node, the same slabs that the 
+ * first touch of the arrays puts on that node. In each band of time,
+ * every node walks the upright trapezoid of its slab, then the inverted
+ * trapezoid on the seam to its right (across the periodic boundary for
+ * the last node); the bands are as high as the slabs allow. 'g' walks 
+ * one trapezoid with the recursion of the caller : g(t0, t1, grid)
+ */
+template <int N_RANK> template <typename G>
+inline void Algorithm<N_RANK>::numa_slab_cut(int t0, int t1, grid_info<N_RANK> const grid, bool boundary, G const & g)
+{
+    const int l_dim = N_RANK-1;
+    const int l_nodes = pochoir_numa_nodes();
+    const int s = slope_[l_dim];
+    const int lb = grid.x1[l_dim] - grid.x0[l_dim];
+    const bool l_wrap = (boundary && lb == phys_length_[l_dim] 
+                      && grid.dx0[l_dim] == 0 && grid.dx1[l_dim] == 0);
+    /* the narrowest slab bounds the height of a band */
+    const int l_min_slab = lb / l_nodes;
+    const int l_band = (s == 0) ? (t1 - t0) : l_min_slab / (2 * s);
+
+    if (l_nodes <= 1 || grid.dx0[l_dim] != 0 || grid.dx1[l_dim] != 0 || l_band < 1) {
+        g(t0, t1, grid);
+        return;
+    }
+    for (int t = t0; t < t1; t += l_band) {
+        const int l_t1 = min(t + l_band, t1);
+        /* upright trapezoids, the outer sides of a non-periodic grid 
+         * stay where they are
+         */
+        pochoir_on_nodes([&](int n) {
+            grid_info<N_RANK> l_grid = grid;
+            l_grid.x0[l_dim] = grid.x0[l_dim] + pochoir_numa_slab(n, l_nodes, lb);
+            l_grid.x1[l_dim] = grid.x0[l_dim] + pochoir_numa_slab(n+1, l_nodes, lb);
+            l_grid.dx0[l_dim] = (n == 0 && !l_wrap) ? 0 : s;
+            l_grid.dx1[l_dim] = (n == l_nodes-1 && !l_wrap) ? 0 : -s;
+            g(t, l_t1, l_grid);
+        });
+        if (s == 0)
+            continue;
+        /* inverted trapezoids on the seams */
+        pochoir_on_nodes([&](int n) {
+            if (n == l_nodes-1 && !l_wrap)
+                return;
+            grid_info<N_RANK> l_grid = grid;
+            l_grid.x0[l_dim] = l_grid.x1[l_dim] = grid.x0[l_dim] + pochoir_numa_slab(n+1, l_nodes, lb);
+            l_grid.dx0[l_dim] = -s;
+            l_grid.dx1[l_dim] = s;
+            g(t, l_t1, l_grid);
+        });
+    }
+}
+
 /* following are the procedures for obase with duality */
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::duo_sim_obase_space_cut(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -594,13 +862,13 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut(int t0, int t1, grid_info
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     duo_sim_obase_bicut(l_son->t0, l_son->t1, l_son->grid, f);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -608,8 +876,12 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut(int t0, int t1, grid_info
                 pop_queue(curr_dep_pointer);
                 if (queue_len_[curr_dep_pointer] == 0)
                     duo_sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
-                else
-                    cilk_spawn duo_sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
+                else {
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(duo_sim_obase_bicut(l_t0, l_t1, l_son_grid, f));
+                }
 #endif
             } else {
                 /* performing a space cut on dimension 'level' */
@@ -695,7 +967,7 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut(int t0, int t1, grid_info
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
@@ -705,6 +977,7 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut(int t0, int t1, grid_info
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::duo_sim_obase_space_cut_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -724,13 +997,13 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut_p(int t0, int t1, grid_in
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     duo_sim_obase_bicut_p(l_son->t0, l_son->t1, l_son->grid, f, bf);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -739,7 +1012,10 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut_p(int t0, int t1, grid_in
                 if (queue_len_[curr_dep_pointer] == 0) {
                     duo_sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
                 } else {
-                    cilk_spawn duo_sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(duo_sim_obase_bicut_p(l_t0, l_t1, l_son_grid, f, bf));
                 }
 #endif
             } else {
@@ -864,7 +1140,7 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut_p(int t0, int t1, grid_in
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
@@ -873,6 +1149,7 @@ inline void Algorithm<N_RANK>::duo_sim_obase_space_cut_p(int t0, int t1, grid_in
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::sim_obase_space_cut(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -892,13 +1169,13 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut(int t0, int t1, grid_info<N_R
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     sim_obase_bicut(l_son->t0, l_son->t1, l_son->grid, f);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -906,8 +1183,12 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut(int t0, int t1, grid_info<N_R
                 pop_queue(curr_dep_pointer);
                 if (queue_len_[curr_dep_pointer] == 0)
                     sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
-                else
-                    cilk_spawn sim_obase_bicut(l_father->t0, l_father->t1, l_father->grid, f);
+                else {
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(sim_obase_bicut(l_t0, l_t1, l_son_grid, f));
+                }
 #endif
             } else {
                 /* performing a space cut on dimension 'level' */
@@ -977,7 +1258,7 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut(int t0, int t1, grid_info<N_R
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
@@ -987,6 +1268,7 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut(int t0, int t1, grid_info<N_R
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::sim_obase_space_cut_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+    pochoir_task_frame;
     queue_info *l_father;
     queue_info circular_queue_[2][ALGOR_QUEUE_SIZE];
     int queue_head_[2], queue_tail_[2], queue_len_[2];
@@ -1006,13 +1288,13 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut_p(int t0, int t1, grid_info<N
 #if USE_CILK_FOR 
                 /* use cilk_for to spawn all the sub-grid */
 // #pragma cilk_grainsize = 1
-                cilk_for (int j = 0; j < queue_len_[curr_dep_pointer]; ++j) {
+                pochoir_for (j, 0, queue_len_[curr_dep_pointer]) {
                     int i = pmod((queue_head_[curr_dep_pointer]+j), ALGOR_QUEUE_SIZE);
                     queue_info * l_son = &(circular_queue_[curr_dep_pointer][i]);
                     /* assert all the sub-grid has done N_RANK spatial cuts */
                     assert(l_son->level == -1);
                     sim_obase_bicut_p(l_son->t0, l_son->t1, l_son->grid, f, bf);
-                } /* end cilk_for */
+                } pochoir_for_end; /* end pochoir_for */
                 queue_head_[curr_dep_pointer] = queue_tail_[curr_dep_pointer] = 0;
                 queue_len_[curr_dep_pointer] = 0;
 #else
@@ -1021,7 +1303,10 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut_p(int t0, int t1, grid_info<N
                 if (queue_len_[curr_dep_pointer] == 0) {
                     sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
                 } else {
-                    cilk_spawn sim_obase_bicut_p(l_father->t0, l_father->t1, l_father->grid, f, bf);
+                    /* the queue entry may be reused before the spawned call runs */
+                    const int l_t0 = l_father->t0, l_t1 = l_father->t1;
+                    const grid_info<N_RANK> l_son_grid = l_father->grid;
+                    pochoir_spawn(sim_obase_bicut_p(l_t0, l_t1, l_son_grid, f, bf));
                 }
 #endif
             } else {
@@ -1103,7 +1388,7 @@ inline void Algorithm<N_RANK>::sim_obase_space_cut_p(int t0, int t1, grid_info<N
             } /* end if (performing a space cut) */
         } /* end while (queue_len_[curr_dep] > 0) */
 #if !USE_CILK_FOR
-        cilk_sync;
+        pochoir_sync;
 #endif
         assert(queue_len_[curr_dep_pointer] == 0);
     } /* end for (curr_dep < N_RANK+1) */
@@ -1128,8 +1413,9 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_bicut(int t0, int t1, grid_
         lb = (grid.x1[i] - grid.x0[i]);
         tb = (grid.x1[i] + grid.dx1[i] * lt - grid.x0[i] - grid.dx0[i] * lt);
         bool cut_lb = (lb < tb);
-        thres = (slope_[i] * lt);
-        sim_can_cut = sim_can_cut || (cut_lb ? (lb >= 2 * thres & lb > dx_recursive_[i]) : (tb >= 2 * thres & lb > dx_recursive_[i]));
+        /* the gray minizoid has to fit in between */
+        thres = (slope0_[i] + slope1_[i]) * lt;
+        sim_can_cut = sim_can_cut || (cut_lb ? (lb >= thres & lb > dx_recursive_[i]) : (tb >= thres & lb > dx_recursive_[i]));
         /* as long as there's one dimension can conduct a cut, we conduct a 
          * multi-dimensional cut!
          */
@@ -1147,7 +1433,11 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_bicut(int t0, int t1, grid_
     // sim_count_cut[l_count_cut] = (l_count_cut > 0 ? sim_count_cut[l_count_cut] + 1 : sim_count_cut[l_count_cut]);
         ++sim_count_cut[l_count_cut];
 #endif
+#if POCHOIR_DATAFLOW
+        shorter_duo_sim_obase_dataflow(t0, t1, grid, f);
+#else
         shorter_duo_sim_obase_space_cut(t0, t1, grid, f);
+#endif
         return;
     // } else if (lt > dt_recursive_ && l_total_points > Z) {
     } else if (lt > dt_recursive_) {
@@ -1276,14 +1566,14 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_bicut_p(int t0, int t1, gri
         bool l_touch_boundary = touch_boundary(i, lt, l_father_grid);
         lb = (grid.x1[i] - grid.x0[i]);
         tb = (grid.x1[i] + grid.dx1[i] * lt - grid.x0[i] - grid.dx0[i] * lt);
-        thres = (slope_[i] * lt);
+        thres = (slope0_[i] + slope1_[i]) * lt;
         /* l_father_grid may be mapped to a new region in touch_boundary() */
         /* for the initial cut, we exclude the begining and end point to minimize
          * the overhead on boundary
         */
         /* lb == phys_length_[i] indicates an initial cut! */
         bool cut_lb = (lb < tb);
-        sim_can_cut = sim_can_cut || (cut_lb ? (l_touch_boundary ? (lb >= 2 * thres & lb > dx_recursive_boundary_[i]) : (lb >= 2 * thres & lb > dx_recursive_[i])) : (l_touch_boundary ? (tb >= 2 * thres & lb > dx_recursive_boundary_[i]) : (tb > 2 * thres & lb > dx_recursive_[i])));
+        sim_can_cut = sim_can_cut || (cut_lb ? (l_touch_boundary ? (lb >= thres & lb > dx_recursive_boundary_[i]) : (lb >= thres & lb > dx_recursive_[i])) : (l_touch_boundary ? (tb >= thres & lb > dx_recursive_boundary_[i]) : (tb > thres & lb > dx_recursive_[i])));
         call_boundary |= l_touch_boundary;
 #if STAT
         l_count_cut = (l_can_cut ? l_count_cut + 1 : l_count_cut);
@@ -1304,10 +1594,17 @@ inline void Algorithm<N_RANK>::shorter_duo_sim_obase_bicut_p(int t0, int t1, gri
     // sim_count_cut[l_count_cut] = (l_count_cut > 0 ? sim_count_cut[l_count_cut] + 1 : sim_count_cut[l_count_cut]);
         ++sim_count_cut[l_count_cut];
 #endif
+#if POCHOIR_DATAFLOW
+        if (call_boundary) 
+            shorter_duo_sim_obase_dataflow_p(t0, t1, l_father_grid, f, bf);
+        else
+            shorter_duo_sim_obase_dataflow(t0, t1, l_father_grid, f);
+#else
         if (call_boundary) 
             shorter_duo_sim_obase_space_cut_p(t0, t1, l_father_grid, f, bf);
         else
             shorter_duo_sim_obase_space_cut(t0, t1, l_father_grid, f);
+#endif
         return;
     } 
 
@@ -1651,6 +1948,7 @@ inline void Algorithm<N_RANK>::sim_obase_bicut_p(int t0, int t1, grid_info<N_RAN
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::walk_adaptive(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+	pochoir_task_frame;
 	/* for the initial cut on each dimension, cut into exact N_CORES pieces,
 	   for the rest cut into that dimension, cut into as many as we can!
 	 */
@@ -1691,34 +1989,34 @@ inline void Algorithm<N_RANK>::walk_adaptive(int t0, int t1, grid_info<N_RANK> c
 					l_grid.dx0[i] = slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * (j+1);
 					l_grid.dx1[i] = -slope_[i];
-					cilk_spawn walk_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(walk_adaptive(t0, t1, l_grid, f));
 				}
 	//			j_loc = r-1;
 				l_grid.x0[i] = grid.x0[i] + sep * (r-1);
 				l_grid.dx0[i] = slope_[i];
 				l_grid.x1[i] = grid.x1[i];
 				l_grid.dx1[i] = -slope_[i];
-				cilk_spawn walk_adaptive(t0, t1, l_grid, f);
+				pochoir_spawn(walk_adaptive(t0, t1, l_grid, f));
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				if (grid.dx0[i] != slope_[i]) {
 					l_grid.x0[i] = grid.x0[i]; l_grid.dx0[i] = grid.dx0[i];
 					l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope_[i];
-					cilk_spawn walk_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(walk_adaptive(t0, t1, l_grid, f));
 				}
 				for (int j = 1; j < r; ++j) {
 					l_grid.x0[i] = grid.x0[i] + sep * j;
 					l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * j;
 					l_grid.dx1[i] = slope_[i];
-					cilk_spawn walk_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(walk_adaptive(t0, t1, l_grid, f));
 				}
 				if (grid.dx1[i] != -slope_[i]) {
 					l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x1[i]; l_grid.dx1[i] = grid.dx1[i];
-					cilk_spawn walk_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(walk_adaptive(t0, t1, l_grid, f));
 				}
 #if 0
 				printf("%s:%d cut into %d dim\n", __FUNCTION__, __LINE__, i);
@@ -1761,6 +2059,7 @@ static int count_internal = 0;
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::walk_bicut_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -1774,7 +2073,7 @@ inline void Algorithm<N_RANK>::walk_bicut_boundary_p(int t0, int t1, grid_info<N
 	for (int i = 0; i < N_RANK; ++i) {
         l_touch_boundary[i] = touch_boundary(i, lt, l_father_grid);
 		lb[i] = (l_father_grid.x1[i] - l_father_grid.x0[i]);
-		thres[i] = 2 * (2 * slope_[i] * lt);
+		thres[i] = 2 * (slope0_[i] + slope1_[i]) * lt;
 		call_boundary |= l_touch_boundary[i];
 	}	
 
@@ -1788,19 +2087,19 @@ inline void Algorithm<N_RANK>::walk_bicut_boundary_p(int t0, int t1, grid_info<N
 			int l_end = (l_father_grid.x1[i]);
 
 			l_son_grid.x0[i] = l_start;
-			l_son_grid.dx0[i] = slope_[i];
+			l_son_grid.dx0[i] = slope0_[i];
 			l_son_grid.x1[i] = l_start + sep;
-			l_son_grid.dx1[i] = -slope_[i];
+			l_son_grid.dx1[i] = -slope1_[i];
             if (call_boundary) {
-                cilk_spawn walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                pochoir_spawn(walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
             } else {
-                cilk_spawn walk_bicut(t0, t1, l_son_grid, f);
+                pochoir_spawn(walk_bicut(t0, t1, l_son_grid, f));
             }
 
 			l_son_grid.x0[i] = l_start + sep;
-			l_son_grid.dx0[i] = slope_[i];
+			l_son_grid.dx0[i] = slope0_[i];
 			l_son_grid.x1[i] = l_end;
-			l_son_grid.dx1[i] = -slope_[i];
+			l_son_grid.dx1[i] = -slope1_[i];
             if (call_boundary) {
                 walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
             } else {
@@ -1809,50 +2108,50 @@ inline void Algorithm<N_RANK>::walk_bicut_boundary_p(int t0, int t1, grid_info<N
 #if DEBUG
 			print_sync(stdout);
 #endif
-			cilk_sync;
+			pochoir_sync;
 
 			l_son_grid.x0[i] = l_start + sep;
-			l_son_grid.dx0[i] = -slope_[i];
+			l_son_grid.dx0[i] = -slope1_[i];
 			l_son_grid.x1[i] = l_start + sep;
-			l_son_grid.dx1[i] = slope_[i];
+			l_son_grid.dx1[i] = slope0_[i];
             if (call_boundary) {
-                cilk_spawn walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                pochoir_spawn(walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
             } else {
-                cilk_spawn walk_bicut(t0, t1, l_son_grid, f);
+                pochoir_spawn(walk_bicut(t0, t1, l_son_grid, f));
             }
 
 			if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
         //        printf("merge triagles!\n");
 				l_son_grid.x0[i] = l_end;
-				l_son_grid.dx0[i] = -slope_[i];
+				l_son_grid.dx0[i] = -slope1_[i];
 				l_son_grid.x1[i] = l_end;
-				l_son_grid.dx1[i] = slope_[i];
+				l_son_grid.dx1[i] = slope0_[i];
                 if (call_boundary) {
-                    cilk_spawn walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                    pochoir_spawn(walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                 } else {
-                    cilk_spawn walk_bicut(t0, t1, l_son_grid, f);
+                    pochoir_spawn(walk_bicut(t0, t1, l_son_grid, f));
                 }
 			} else {
-				if (l_father_grid.dx0[i] != slope_[i]) {
+				if (l_father_grid.dx0[i] != slope0_[i]) {
 					l_son_grid.x0[i] = l_start; 
 					l_son_grid.dx0[i] = l_father_grid.dx0[i];
 					l_son_grid.x1[i] = l_start; 
-					l_son_grid.dx1[i] = slope_[i];
+					l_son_grid.dx1[i] = slope0_[i];
                     if (call_boundary) {
-                        cilk_spawn walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn walk_bicut(t0, t1, l_son_grid, f);
+                        pochoir_spawn(walk_bicut(t0, t1, l_son_grid, f));
                     }
 				}
-				if (l_father_grid.dx1[i] != -slope_[i]) {
+				if (l_father_grid.dx1[i] != -slope1_[i]) {
 					l_son_grid.x0[i] = l_end; 
-					l_son_grid.dx0[i] = -slope_[i];
+					l_son_grid.dx0[i] = -slope1_[i];
 					l_son_grid.x1[i] = l_end; 
 					l_son_grid.dx1[i] = l_father_grid.dx1[i];
                     if (call_boundary) {
-                        cilk_spawn walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(walk_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn walk_bicut(t0, t1, l_son_grid, f);
+                        pochoir_spawn(walk_bicut(t0, t1, l_son_grid, f));
                     }
 				}
 			}
@@ -1913,6 +2212,7 @@ inline void Algorithm<N_RANK>::walk_bicut_boundary_p(int t0, int t1, grid_info<N
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -1968,9 +2268,9 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 					l_son_grid.x1[i] = l_start + sep * (j+1);
 					l_son_grid.dx1[i] = -slope_[i];
                     if (call_boundary) {
-                        cilk_spawn walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn walk_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(walk_adaptive(t0, t1, l_son_grid, f));
                     }
 				}
 				l_son_grid.x0[i] = l_start + sep * j;
@@ -1985,16 +2285,16 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				for (j = 1; j < r; ++j) {
 					l_son_grid.x0[i] = l_start + sep * j;
 					l_son_grid.dx0[i] = -slope_[i];
 					l_son_grid.x1[i] = l_start + sep * j;
 					l_son_grid.dx1[i] = slope_[i];
                     if (call_boundary) {
-                        cilk_spawn walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn walk_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(walk_adaptive(t0, t1, l_son_grid, f));
                     }
 				}
 				if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
@@ -2004,9 +2304,9 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 					l_son_grid.x1[i] = l_end;
 					l_son_grid.dx1[i] = slope_[i];
                     if (call_boundary) {
-                        cilk_spawn walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn walk_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(walk_adaptive(t0, t1, l_son_grid, f));
                     }
 				} else {
 					if (l_father_grid.dx0[i] != slope_[i]) {
@@ -2015,9 +2315,9 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 						l_son_grid.x1[i] = l_start; 
 						l_son_grid.dx1[i] = slope_[i];
                         if (call_boundary) {
-                            cilk_spawn walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf);
+                            pochoir_spawn(walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf));
                         } else {
-                            cilk_spawn walk_adaptive(t0, t1, l_son_grid, f);
+                            pochoir_spawn(walk_adaptive(t0, t1, l_son_grid, f));
                         }
 					}
 					if (l_father_grid.dx1[i] != -slope_[i]) {
@@ -2026,9 +2326,9 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 						l_son_grid.x1[i] = l_end; 
 						l_son_grid.dx1[i] = l_father_grid.dx1[i];
                         if (call_boundary) {
-                            cilk_spawn walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf);
+                            pochoir_spawn(walk_ncores_boundary_p(t0, t1, l_son_grid, f, bf));
                         } else {
-                            cilk_spawn walk_adaptive(t0, t1, l_son_grid, f);
+                            pochoir_spawn(walk_adaptive(t0, t1, l_son_grid, f));
                         }
 					}
 				}
@@ -2068,6 +2368,7 @@ inline void Algorithm<N_RANK>::walk_ncores_boundary_p(int t0, int t1, grid_info<
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::obase_bicut(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+	pochoir_task_frame;
 	/* for the initial cut on each dimension, cut into exact N_CORES pieces,
 	   for the rest cut into that dimension, cut into as many as we can!
 	 */
@@ -2091,33 +2392,33 @@ inline void Algorithm<N_RANK>::obase_bicut(int t0, int t1, grid_info<N_RANK> con
 			l_grid.dx0[i] = slope_[i];
 			l_grid.x1[i] = grid.x0[i] + sep;
 			l_grid.dx1[i] = -slope_[i];
-			cilk_spawn obase_bicut(t0, t1, l_grid, f);
+			pochoir_spawn(obase_bicut(t0, t1, l_grid, f));
 
 			l_grid.x0[i] = grid.x0[i] + sep;
 			l_grid.dx0[i] = slope_[i];
 			l_grid.x1[i] = grid.x1[i];
 			l_grid.dx1[i] = -slope_[i];
-			cilk_spawn obase_bicut(t0, t1, l_grid, f);
+			pochoir_spawn(obase_bicut(t0, t1, l_grid, f));
 #if DEBUG
 //			print_sync(stdout);
 #endif
-			cilk_sync;
+			pochoir_sync;
 			if (grid.dx0[i] != slope_[i]) {
 				l_grid.x0[i] = grid.x0[i]; l_grid.dx0[i] = grid.dx0[i];
 				l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope_[i];
-				cilk_spawn obase_bicut(t0, t1, l_grid, f);
+				pochoir_spawn(obase_bicut(t0, t1, l_grid, f));
 			}
 
 			l_grid.x0[i] = grid.x0[i] + sep;
 			l_grid.dx0[i] = -slope_[i];
 			l_grid.x1[i] = grid.x0[i] + sep;
 			l_grid.dx1[i] = slope_[i];
-			cilk_spawn obase_bicut(t0, t1, l_grid, f);
+			pochoir_spawn(obase_bicut(t0, t1, l_grid, f));
 
 			if (grid.dx1[i] != -slope_[i]) {
 				l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope_[i];
 				l_grid.x1[i] = grid.x1[i]; l_grid.dx1[i] = grid.dx1[i];
-				cilk_spawn obase_bicut(t0, t1, l_grid, f);
+				pochoir_spawn(obase_bicut(t0, t1, l_grid, f));
 			}
 #if DEBUG
 			printf("%s:%d cut into %d dim\n", __FUNCTION__, __LINE__, i);
@@ -2159,6 +2460,7 @@ inline void Algorithm<N_RANK>::obase_bicut(int t0, int t1, grid_info<N_RANK> con
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::obase_m(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+	pochoir_task_frame;
 	/* for the initial cut on each dimension, cut into exact N_CORES pieces,
 	   for the rest cut into that dimension, cut into as many as we can!
 	 */
@@ -2200,34 +2502,34 @@ inline void Algorithm<N_RANK>::obase_m(int t0, int t1, grid_info<N_RANK> const g
 					l_grid.dx0[i] = slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * (j+1);
 					l_grid.dx1[i] = -slope_[i];
-					cilk_spawn obase_m(t0, t1, l_grid, f);
+					pochoir_spawn(obase_m(t0, t1, l_grid, f));
 				}
 	//			j_loc = r-1;
 				l_grid.x0[i] = grid.x0[i] + sep * (r-1);
 				l_grid.dx0[i] = slope_[i];
 				l_grid.x1[i] = grid.x1[i];
 				l_grid.dx1[i] = -slope_[i];
-				cilk_spawn obase_m(t0, t1, l_grid, f);
+				pochoir_spawn(obase_m(t0, t1, l_grid, f));
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				if (grid.dx0[i] != slope_[i]) {
 					l_grid.x0[i] = grid.x0[i]; l_grid.dx0[i] = grid.dx0[i];
 					l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope_[i];
-					cilk_spawn obase_m(t0, t1, l_grid, f);
+					pochoir_spawn(obase_m(t0, t1, l_grid, f));
 				}
 				for (int j = 1; j < r; ++j) {
 					l_grid.x0[i] = grid.x0[i] + sep * j;
 					l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * j;
 					l_grid.dx1[i] = slope_[i];
-					cilk_spawn obase_m(t0, t1, l_grid, f);
+					pochoir_spawn(obase_m(t0, t1, l_grid, f));
 				}
 				if (grid.dx1[i] != -slope_[i]) {
 					l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x1[i]; l_grid.dx1[i] = grid.dx1[i];
-					cilk_spawn obase_m(t0, t1, l_grid, f);
+					pochoir_spawn(obase_m(t0, t1, l_grid, f));
 				}
 #if 0
 				printf("%s:%d cut into %d dim\n", __FUNCTION__, __LINE__, i);
@@ -2265,6 +2567,7 @@ inline void Algorithm<N_RANK>::obase_m(int t0, int t1, grid_info<N_RANK> const g
 template <int N_RANK> template <typename F>
 inline void Algorithm<N_RANK>::obase_adaptive(int t0, int t1, grid_info<N_RANK> const grid, F const & f)
 {
+	pochoir_task_frame;
 	/* for the initial cut on each dimension, cut into exact N_CORES pieces,
 	   for the rest cut into that dimension, cut into as many as we can!
 	 */
@@ -2303,34 +2606,34 @@ inline void Algorithm<N_RANK>::obase_adaptive(int t0, int t1, grid_info<N_RANK>
 					l_grid.dx0[i] = slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * (j+1);
 					l_grid.dx1[i] = -slope_[i];
-					cilk_spawn obase_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(obase_adaptive(t0, t1, l_grid, f));
 				}
 	//			j_loc = r-1;
 				l_grid.x0[i] = grid.x0[i] + sep * (r-1);
 				l_grid.dx0[i] = slope_[i];
 				l_grid.x1[i] = grid.x1[i];
 				l_grid.dx1[i] = -slope_[i];
-				cilk_spawn obase_adaptive(t0, t1, l_grid, f);
+				pochoir_spawn(obase_adaptive(t0, t1, l_grid, f));
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				if (grid.dx0[i] != slope_[i]) {
 					l_grid.x0[i] = grid.x0[i]; l_grid.dx0[i] = grid.dx0[i];
 					l_grid.x1[i] = grid.x0[i]; l_grid.dx1[i] = slope_[i];
-					cilk_spawn obase_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(obase_adaptive(t0, t1, l_grid, f));
 				}
 				for (int j = 1; j < r; ++j) {
 					l_grid.x0[i] = grid.x0[i] + sep * j;
 					l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x0[i] + sep * j;
 					l_grid.dx1[i] = slope_[i];
-					cilk_spawn obase_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(obase_adaptive(t0, t1, l_grid, f));
 				}
 				if (grid.dx1[i] != -slope_[i]) {
 					l_grid.x0[i] = grid.x1[i]; l_grid.dx0[i] = -slope_[i];
 					l_grid.x1[i] = grid.x1[i]; l_grid.dx1[i] = grid.dx1[i];
-					cilk_spawn obase_adaptive(t0, t1, l_grid, f);
+					pochoir_spawn(obase_adaptive(t0, t1, l_grid, f));
 				}
 #if 0
 				printf("%s:%d cut into %d dim\n", __FUNCTION__, __LINE__, i);
@@ -2368,6 +2671,7 @@ inline void Algorithm<N_RANK>::obase_adaptive(int t0, int t1, grid_info<N_RANK>
 template <int N_RANK> template <typename BF>
 inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -2397,7 +2701,7 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 			l_son_grid.dx0[i] = slope_[i];
 			l_son_grid.x1[i] = l_start + sep;
 			l_son_grid.dx1[i] = -slope_[i];
-            cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, bf);
+            pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, bf));
 
 			l_son_grid.x0[i] = l_start + sep * j;
 			l_son_grid.dx0[i] = slope_[i];
@@ -2407,33 +2711,33 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 #if DEBUG
 //			print_sync(stdout);
 #endif
-			cilk_sync;
+			pochoir_sync;
 			l_son_grid.x0[i] = l_start + sep;
 			l_son_grid.dx0[i] = -slope_[i];
 			l_son_grid.x1[i] = l_start + sep;
 			l_son_grid.dx1[i] = slope_[i];
-            cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, bf);
+            pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, bf));
 			if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
         //        printf("merge triagles!\n");
 				l_son_grid.x0[i] = l_end;
 				l_son_grid.dx0[i] = -slope_[i];
 				l_son_grid.x1[i] = l_end;
 				l_son_grid.dx1[i] = slope_[i];
-                cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, bf);
+                pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, bf));
 			} else {
 				if (l_father_grid.dx0[i] != slope_[i]) {
 					l_son_grid.x0[i] = l_start; 
 					l_son_grid.dx0[i] = l_father_grid.dx0[i];
 					l_son_grid.x1[i] = l_start; 
 					l_son_grid.dx1[i] = slope_[i];
-                    cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, bf);
+                    pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, bf));
 				}
 				if (l_father_grid.dx1[i] != -slope_[i]) {
 					l_son_grid.x0[i] = l_end; 
 					l_son_grid.dx0[i] = -slope_[i];
 					l_son_grid.x1[i] = l_end; 
 					l_son_grid.dx1[i] = l_father_grid.dx1[i];
-                    cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, bf);
+                    pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, bf));
 				}
 			}
             return;
@@ -2464,6 +2768,7 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 template <int N_RANK> template <typename BF>
 inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -2503,7 +2808,7 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 					l_son_grid.dx0[i] = slope_[i];
 					l_son_grid.x1[i] = l_start + sep * (j+1);
 					l_son_grid.dx1[i] = -slope_[i];
-                    cilk_spawn obase_boundary_p(t0, t1, l_son_grid, bf);
+                    pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, bf));
 				}
 				l_son_grid.x0[i] = l_start + sep * j;
 				l_son_grid.dx0[i] = slope_[i];
@@ -2513,13 +2818,13 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				for (j = 1; j < r; ++j) {
 					l_son_grid.x0[i] = l_start + sep * j;
 					l_son_grid.dx0[i] = -slope_[i];
 					l_son_grid.x1[i] = l_start + sep * j;
 					l_son_grid.dx1[i] = slope_[i];
-                    cilk_spawn obase_boundary_p(t0, t1, l_son_grid, bf);
+                    pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, bf));
 				}
 				if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
             //        printf("merge triagles!\n");
@@ -2527,21 +2832,21 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 					l_son_grid.dx0[i] = -slope_[i];
 					l_son_grid.x1[i] = l_end;
 					l_son_grid.dx1[i] = slope_[i];
-                    cilk_spawn obase_boundary_p(t0, t1, l_son_grid, bf);
+                    pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, bf));
 				} else {
 					if (l_father_grid.dx0[i] != slope_[i]) {
 						l_son_grid.x0[i] = l_start; 
 						l_son_grid.dx0[i] = l_father_grid.dx0[i];
 						l_son_grid.x1[i] = l_start; 
 						l_son_grid.dx1[i] = slope_[i];
-                        cilk_spawn obase_boundary_p(t0, t1, l_son_grid, bf);
+                        pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, bf));
 					}
 					if (l_father_grid.dx1[i] != -slope_[i]) {
 						l_son_grid.x0[i] = l_end; 
 						l_son_grid.dx0[i] = -slope_[i];
 						l_son_grid.x1[i] = l_end; 
 						l_son_grid.dx1[i] = l_father_grid.dx1[i];
-                        cilk_spawn obase_boundary_p(t0, t1, l_son_grid, bf);
+                        pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, bf));
 					}
 				}
 				cut_yet = true;
@@ -2572,6 +2877,7 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -2602,9 +2908,9 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 			l_son_grid.x1[i] = l_start + sep;
 			l_son_grid.dx1[i] = -slope_[i];
             if (call_boundary) {
-                cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
             } else {
-                cilk_spawn obase_bicut(t0, t1, l_son_grid, f);
+                pochoir_spawn(obase_bicut(t0, t1, l_son_grid, f));
             }
 
 			l_son_grid.x0[i] = l_start + sep;
@@ -2616,16 +2922,16 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
             } else {
                 obase_bicut(t0, t1, l_son_grid, f);
             }
-			cilk_sync;
+			pochoir_sync;
 
 			l_son_grid.x0[i] = l_start + sep;
 			l_son_grid.dx0[i] = -slope_[i];
 			l_son_grid.x1[i] = l_start + sep;
 			l_son_grid.dx1[i] = slope_[i];
             if (call_boundary) {
-                cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
             } else {
-                cilk_spawn obase_bicut(t0, t1, l_son_grid, f);
+                pochoir_spawn(obase_bicut(t0, t1, l_son_grid, f));
             }
 
 			if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
@@ -2635,9 +2941,9 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 				l_son_grid.x1[i] = l_end;
 				l_son_grid.dx1[i] = slope_[i];
                 if (call_boundary) {
-                    cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                    pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                 } else {
-                    cilk_spawn obase_bicut(t0, t1, l_son_grid, f);
+                    pochoir_spawn(obase_bicut(t0, t1, l_son_grid, f));
                 }
 			} else {
 				if (l_father_grid.dx0[i] != slope_[i]) {
@@ -2646,9 +2952,9 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 					l_son_grid.x1[i] = l_start; 
 					l_son_grid.dx1[i] = slope_[i];
                     if (call_boundary) {
-                        cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn obase_bicut(t0, t1, l_son_grid, f);
+                        pochoir_spawn(obase_bicut(t0, t1, l_son_grid, f));
                     }
 				}
 				if (l_father_grid.dx1[i] != -slope_[i]) {
@@ -2657,9 +2963,9 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 					l_son_grid.x1[i] = l_end; 
 					l_son_grid.dx1[i] = l_father_grid.dx1[i];
                     if (call_boundary) {
-                        cilk_spawn obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(obase_bicut_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn obase_bicut(t0, t1, l_son_grid, f);
+                        pochoir_spawn(obase_bicut(t0, t1, l_son_grid, f));
                     }
 				}
 			}
@@ -2716,6 +3022,7 @@ inline void Algorithm<N_RANK>::obase_bicut_boundary_p(int t0, int t1, grid_info<
 template <int N_RANK> template <typename F, typename BF>
 inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK> const grid, F const & f, BF const & bf)
 {
+	pochoir_task_frame;
 	/* cut into exact N_CORES pieces */
 	/* Indirect memory access is expensive */
 	int lt = t1 - t0;
@@ -2772,9 +3079,9 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 					l_son_grid.x1[i] = l_start + sep * (j+1);
 					l_son_grid.dx1[i] = -slope_[i];
                     if (call_boundary) {
-                        cilk_spawn obase_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn obase_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(obase_adaptive(t0, t1, l_son_grid, f));
                     }
 				}
 				l_son_grid.x0[i] = l_start + sep * j;
@@ -2789,16 +3096,16 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 #if DEBUG
 //				print_sync(stdout);
 #endif
-				cilk_sync;
+				pochoir_sync;
 				for (j = 1; j < r; ++j) {
 					l_son_grid.x0[i] = l_start + sep * j;
 					l_son_grid.dx0[i] = -slope_[i];
 					l_son_grid.x1[i] = l_start + sep * j;
 					l_son_grid.dx1[i] = slope_[i];
                     if (call_boundary) {
-                        cilk_spawn obase_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn obase_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(obase_adaptive(t0, t1, l_son_grid, f));
                     }
 				}
 				if (l_start == phys_grid_.x0[i] && l_end == phys_grid_.x1[i]) {
@@ -2808,9 +3115,9 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 					l_son_grid.x1[i] = l_end;
 					l_son_grid.dx1[i] = slope_[i];
                     if (call_boundary) {
-                        cilk_spawn obase_boundary_p(t0, t1, l_son_grid, f, bf);
+                        pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, f, bf));
                     } else {
-                        cilk_spawn obase_adaptive(t0, t1, l_son_grid, f);
+                        pochoir_spawn(obase_adaptive(t0, t1, l_son_grid, f));
                     }
 				} else {
 					if (l_father_grid.dx0[i] != slope_[i]) {
@@ -2819,9 +3126,9 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 						l_son_grid.x1[i] = l_start; 
 						l_son_grid.dx1[i] = slope_[i];
                         if (call_boundary) {
-                            cilk_spawn obase_boundary_p(t0, t1, l_son_grid, f, bf);
+                            pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, f, bf));
                         } else {
-                            cilk_spawn obase_adaptive(t0, t1, l_son_grid, f);
+                            pochoir_spawn(obase_adaptive(t0, t1, l_son_grid, f));
                         }
 					}
 					if (l_father_grid.dx1[i] != -slope_[i]) {
@@ -2830,9 +3137,9 @@ inline void Algorithm<N_RANK>::obase_boundary_p(int t0, int t1, grid_info<N_RANK
 						l_son_grid.x1[i] = l_end; 
 						l_son_grid.dx1[i] = l_father_grid.dx1[i];
                         if (call_boundary) {
-                            cilk_spawn obase_boundary_p(t0, t1, l_son_grid, f, bf);
+                            pochoir_spawn(obase_boundary_p(t0, t1, l_son_grid, f, bf));
                         } else {
-                            cilk_spawn obase_adaptive(t0, t1, l_son_grid, f);
+                            pochoir_spawn(obase_adaptive(t0, t1, l_son_grid, f));
                         }
 					}
 				}
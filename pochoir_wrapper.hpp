@@ -34,6 +34,7 @@
 #include "pochoir_walk.hpp"
 #include "pochoir_walk_recursive.hpp"
 #include "pochoir_walk_loops.hpp"
+#include "pochoir_walk_diamond.hpp"
 
 /* serial_loops() is not necessary because we can call base_case_kernel() to 
  * mimic the same behavior of serial_loops()
@@ -60,232 +61,9 @@ void serial_loops(Pochoir_Domain _tR, Pochoir_Domain _iR, F const & f) {
 	} } 
 } 
 
-/* these are for those fall in full effective region and dont have any boundary conditions */
-template <typename F>
-void pochoir(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const f) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    size_t l_stride[2];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_adaptive(l_t0, l_t1, l_grid, f);
-}
-
-template <typename F>
-void pochoir(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const f) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    size_t l_stride[1];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_adaptive(l_t0, l_t1, l_grid, f);
-}
-
-/* Non-periodic: F is for internal region, and BF is for boundary condition processing */
-template <typename F, typename BF>
-void pochoir(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    size_t l_stride[2];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_boundary(l_t0, l_t1, l_grid, f, bf);
-}
-
-template <typename F, typename BF>
-void pochoir(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    size_t l_stride[1];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_boundary(l_t0, l_t1, l_grid, f, bf);
-}
-
-/* pochoir_p() will only call the Periodic stencil function,
- * while pochoir() may NOT -- Shall we merge the function with those of non-periodic,
- * and just use one parameter to distinguish them???
- */
-template <typename F, typename BF>
-void pochoir_p(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    size_t l_stride[2];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_boundary_p(l_t0, l_t1, l_grid, f, bf);
-}
-
-template <typename F, typename BF>
-void pochoir_p(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    Algorithm<2, grid_info_1>::index_info l_stride;
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.walk_ncores_boundary_p(l_t0, l_t1, l_grid, f, bf);
-}
-
-/* these are for those fall in full effective region and dont have any boundary conditions */
-template <typename F>
-void obase(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const f) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    Algorithm<3, grid_info_2>::index_info l_stride;
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_adaptive(l_t0, l_t1, l_grid, f);
-}
-
-template <typename F>
-void obase(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const f) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    Algorithm<2, grid_info_1>::index_info l_stride;
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_adaptive(l_t0, l_t1, l_grid, f);
-}
-
-/* Non-periodic: F is for internal region, and BF is for boundary condition processing */
-template <typename F, typename BF>
-void obase(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    size_t l_stride[2];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_boundary(l_t0, l_t1, l_grid, f, bf);
-}
-
-template <typename F, typename BF>
-void obase(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    size_t l_stride[1];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_boundary(l_t0, l_t1, l_grid, f, bf);
-}
-
-/* obase_p() will only call the Periodic stencil function,
- * while obase() may NOT -- Shall we merge the function with those of non-periodic,
- * and just use one parameter to distinguish them???
+/* the pochoir() / obase() entry points over Pochoir_Domain were written
+ * for the old Algorithm<N_RANK+1, grid_info_N> walker, which is gone;
+ * a stencil is run through Pochoir::Run() / Run_Obase() instead
  */
-template <typename F, typename BF>
-void obase_p(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, Pochoir_Domain const & _jR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    grid_info_2 l_grid;
-    Algorithm<3, grid_info_2> algor(_slope);
-    size_t l_stride[2];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.x0[1] = _jR.first(); l_grid.x1[1] = _jR.first() + _jR.stride() * _jR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_grid.dx0[1] = 0; l_grid.dx1[1] = 0;
-    l_stride[0] = _iR.stride(); l_stride[1] = _jR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_boundary_p(l_t0, l_t1, l_grid, f, bf);
-}
-
-template <typename F, typename BF>
-void obase_p(Pochoir_Domain const & _tR, Pochoir_Domain const & _iR, const size_t _slope[], F const & f, BF const & bf) {
-	size_t l_t0 = _tR.first(), l_t1 = _tR.last();
-    Algorithm<2, grid_info_1> algor(_slope);
-    grid_info_1 l_grid;
-    size_t l_stride[1];
-
-    l_grid.x0[0] = _iR.first(); l_grid.x1[0] = _iR.first() + _iR.stride() * _iR.size();
-    l_grid.dx0[0] = 0; l_grid.dx1[0] = 0;
-    l_stride[0] = _iR.stride();
-	//algor.walk_serial(l_t0, l_t1, l_grid, f);
-	//algor.base_case_kernel(l_t0, l_t1, l_grid, f);
-    algor.set_initial_grid(l_grid);
-    algor.set_stride(l_stride);
-    algor.obase_boundary_p(l_t0, l_t1, l_grid, f, bf);
-}
 
 #endif /* POCHOIR_WRAPPER_H */